@@ -0,0 +1,157 @@
+/*
+//  bw_api.h
+//
+//  C interface of the weight models of bw for other packages and for services
+//  that embed R. It is not an R-free ABI: the functions are registered with
+//  R_RegisterCCallable and this header looks them up with R_GetCCallable, so a
+//  caller needs R's headers and library, an R session that loaded bw (a package
+//  with bw in its LinkingTo field, or a service that runs Rf_initEmbeddedR and
+//  loads bw) and must call them from R's thread. There is no library of the
+//  models apart from the package. The models run in that R session: bw_run
+//  copies the caller's arrays into R vectors, runs the models of the package on
+//  them and copies the results to the caller's buffers.
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+*/
+
+#ifndef bw_api_h
+#define bw_api_h
+
+#include <R.h>
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Version of the interface: a new version is added for incompatible changes */
+#define BW_API_VERSION 1
+
+/* Status of the functions */
+#define BW_OK               0
+#define BW_ERROR_ARGUMENT   1  /* Invalid handle, size or pointer */
+#define BW_ERROR_VARIABLE   2  /* Variable that is not a numeric result of the model */
+#define BW_ERROR_THREADS    3  /* The models run in R's thread: nthreads must be 1 */
+#define BW_ERROR_MODEL      4  /* The model failed (e.g. invalid values) */
+
+/* Opaque handles. The arrays given to the create functions are not copied when
+   the handles are made: they must live (unchanged) until the handle is destroyed.
+   Each bw_run copies them, so a run needs R memory for its inputs and results. */
+typedef struct bw_population bw_population;
+typedef struct bw_scenario   bw_scenario;
+
+/* Output buffer of a variable (e.g. "Body_Weight") owned by the caller with
+   room for nind x ntimes values (see bw_run) stored by individual:
+   values[i + nind*t] is individual i at time step t. */
+typedef struct {
+    const char* variable;
+    double*     values;
+} bw_buffer;
+
+typedef int            (*bw_api_version_t)(void);
+typedef bw_population* (*bw_adult_population_t)(int nind, const double* bw, const double* ht,
+                                                 const double* age, const double* sex,
+                                                 const double* PAL, const double* pcarb_base,
+                                                 const double* pcarb);
+typedef bw_population* (*bw_child_population_t)(int nind, const double* age, const double* sex,
+                                                 const double* bmiCat, const double* FFM,
+                                                 const double* FM);
+typedef void           (*bw_population_free_t)(bw_population* population);
+typedef bw_scenario*   (*bw_scenario_t)(double days, double dt, int nsteps,
+                                         const double* EIchange, const double* NAchange);
+typedef void           (*bw_scenario_free_t)(bw_scenario* scenario);
+typedef int            (*bw_run_t)(const bw_population* population, const bw_scenario* scenario,
+                                   bw_buffer* buffers, int nbuffers, int nthreads, int* ntimes);
+
+/* Version of the interface of the installed bw */
+static inline int bw_api_version(void){
+    static bw_api_version_t fun = NULL;
+    if (fun == NULL) fun = (bw_api_version_t) R_GetCCallable("bw", "bw_api_version");
+    return fun();
+}
+
+/* Adults: body weight (kg), height (m), age (yrs), sex (0 male, 1 female), physical
+   activity level and proportion of carbohydrates at baseline and after the change */
+static inline bw_population* bw_adult_population(int nind, const double* bw, const double* ht,
+                                                 const double* age, const double* sex,
+                                                 const double* PAL, const double* pcarb_base,
+                                                 const double* pcarb){
+    static bw_adult_population_t fun = NULL;
+    if (fun == NULL) fun = (bw_adult_population_t) R_GetCCallable("bw", "bw_adult_population");
+    return fun(nind, bw, ht, age, sex, PAL, pcarb_base, pcarb);
+}
+
+/* Children: age (yrs), sex (0 male, 1 female), BMI category (1 to 4), fat free
+   mass and fat mass (kg) */
+static inline bw_population* bw_child_population(int nind, const double* age, const double* sex,
+                                                 const double* bmiCat, const double* FFM,
+                                                 const double* FM){
+    static bw_child_population_t fun = NULL;
+    if (fun == NULL) fun = (bw_child_population_t) R_GetCCallable("bw", "bw_child_population");
+    return fun(nind, age, sex, bmiCat, FFM, FM);
+}
+
+static inline void bw_population_free(bw_population* population){
+    static bw_population_free_t fun = NULL;
+    if (fun == NULL) fun = (bw_population_free_t) R_GetCCallable("bw", "bw_population_free");
+    fun(population);
+}
+
+/* Days, time step and changes of energy (kcal) and sodium (mg) intake with nsteps
+   values per individual: EIchange[t + nsteps*i]. For children EIchange is the change
+   from the reference energy intake and NAchange is not used. NULL means no change.
+   nsteps must be at least the ntimes of the run (see bw_run). */
+static inline bw_scenario* bw_scenario_create(double days, double dt, int nsteps,
+                                              const double* EIchange, const double* NAchange){
+    static bw_scenario_t fun = NULL;
+    if (fun == NULL) fun = (bw_scenario_t) R_GetCCallable("bw", "bw_scenario");
+    return fun(days, dt, nsteps, EIchange, NAchange);
+}
+
+static inline void bw_scenario_free(bw_scenario* scenario){
+    static bw_scenario_free_t fun = NULL;
+    if (fun == NULL) fun = (bw_scenario_free_t) R_GetCCallable("bw", "bw_scenario_free");
+    fun(scenario);
+}
+
+/* Run the model of the population in the scenario writing the variables to the
+   buffers; ntimes is the number of time steps written: ceil(days/dt) + 1 for adults
+   and floor((days - 1)/dt) + 1 for children (days counts the first day, as in
+   child_weight). A scenario with fewer than ntimes steps is a BW_ERROR_ARGUMENT.
+   Must be called from R's thread. An R error during the run (e.g. out of memory)
+   is stopped at the run and returned as BW_ERROR_MODEL; the R objects of that run
+   may then stay allocated. */
+static inline int bw_run(const bw_population* population, const bw_scenario* scenario,
+                         bw_buffer* buffers, int nbuffers, int nthreads, int* ntimes){
+    static bw_run_t fun = NULL;
+    if (fun == NULL) fun = (bw_run_t) R_GetCCallable("bw", "bw_run");
+    return fun(population, scenario, buffers, nbuffers, nthreads, ntimes);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* bw_api_h */
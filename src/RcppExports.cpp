@@ -5,8 +5,8 @@
 using namespace Rcpp;
 
 // adult_weight_wrapper
-List adult_weight_wrapper(NumericVector bw, NumericVector ht, NumericVector age, NumericVector sex, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double dt, double days, bool checkValues);
-RcppExport SEXP _bw_adult_weight_wrapper(SEXP bwSEXP, SEXP htSEXP, SEXP ageSEXP, SEXP sexSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP dtSEXP, SEXP daysSEXP, SEXP checkValuesSEXP) {
+List adult_weight_wrapper(NumericVector bw, NumericVector ht, NumericVector age, NumericVector sex, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double dt, double days, bool checkValues, int blocksize, List output);
+RcppExport SEXP _bw_adult_weight_wrapper(SEXP bwSEXP, SEXP htSEXP, SEXP ageSEXP, SEXP sexSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP dtSEXP, SEXP daysSEXP, SEXP checkValuesSEXP, SEXP blocksizeSEXP, SEXP outputSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -22,13 +22,15 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
     Rcpp::traits::input_parameter< double >::type days(daysSEXP);
     Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
-    rcpp_result_gen = Rcpp::wrap(adult_weight_wrapper(bw, ht, age, sex, EIchange, NAchange, PAL, pcarb_base, pcarb, dt, days, checkValues));
+    Rcpp::traits::input_parameter< int >::type blocksize(blocksizeSEXP);
+    Rcpp::traits::input_parameter< List >::type output(outputSEXP);
+    rcpp_result_gen = Rcpp::wrap(adult_weight_wrapper(bw, ht, age, sex, EIchange, NAchange, PAL, pcarb_base, pcarb, dt, days, checkValues, blocksize, output));
     return rcpp_result_gen;
 END_RCPP
 }
 // adult_weight_wrapper_EI
-List adult_weight_wrapper_EI(NumericVector bw, NumericVector ht, NumericVector age, NumericVector sex, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double dt, NumericVector extradata, double days, bool checkValues, bool isEnergy);
-RcppExport SEXP _bw_adult_weight_wrapper_EI(SEXP bwSEXP, SEXP htSEXP, SEXP ageSEXP, SEXP sexSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP dtSEXP, SEXP extradataSEXP, SEXP daysSEXP, SEXP checkValuesSEXP, SEXP isEnergySEXP) {
+List adult_weight_wrapper_EI(NumericVector bw, NumericVector ht, NumericVector age, NumericVector sex, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double dt, NumericVector extradata, double days, bool checkValues, bool isEnergy, int blocksize, List output);
+RcppExport SEXP _bw_adult_weight_wrapper_EI(SEXP bwSEXP, SEXP htSEXP, SEXP ageSEXP, SEXP sexSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP dtSEXP, SEXP extradataSEXP, SEXP daysSEXP, SEXP checkValuesSEXP, SEXP isEnergySEXP, SEXP blocksizeSEXP, SEXP outputSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -46,13 +48,15 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< double >::type days(daysSEXP);
     Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
     Rcpp::traits::input_parameter< bool >::type isEnergy(isEnergySEXP);
-    rcpp_result_gen = Rcpp::wrap(adult_weight_wrapper_EI(bw, ht, age, sex, EIchange, NAchange, PAL, pcarb_base, pcarb, dt, extradata, days, checkValues, isEnergy));
+    Rcpp::traits::input_parameter< int >::type blocksize(blocksizeSEXP);
+    Rcpp::traits::input_parameter< List >::type output(outputSEXP);
+    rcpp_result_gen = Rcpp::wrap(adult_weight_wrapper_EI(bw, ht, age, sex, EIchange, NAchange, PAL, pcarb_base, pcarb, dt, extradata, days, checkValues, isEnergy, blocksize, output));
     return rcpp_result_gen;
 END_RCPP
 }
 // adult_weight_wrapper_EI_fat
-List adult_weight_wrapper_EI_fat(NumericVector bw, NumericVector ht, NumericVector age, NumericVector sex, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double dt, NumericVector input_EI, NumericVector input_fat, double days, bool checkValues);
-RcppExport SEXP _bw_adult_weight_wrapper_EI_fat(SEXP bwSEXP, SEXP htSEXP, SEXP ageSEXP, SEXP sexSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP dtSEXP, SEXP input_EISEXP, SEXP input_fatSEXP, SEXP daysSEXP, SEXP checkValuesSEXP) {
+List adult_weight_wrapper_EI_fat(NumericVector bw, NumericVector ht, NumericVector age, NumericVector sex, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double dt, NumericVector input_EI, NumericVector input_fat, double days, bool checkValues, int blocksize, List output);
+RcppExport SEXP _bw_adult_weight_wrapper_EI_fat(SEXP bwSEXP, SEXP htSEXP, SEXP ageSEXP, SEXP sexSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP dtSEXP, SEXP input_EISEXP, SEXP input_fatSEXP, SEXP daysSEXP, SEXP checkValuesSEXP, SEXP blocksizeSEXP, SEXP outputSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -70,13 +74,30 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< NumericVector >::type input_fat(input_fatSEXP);
     Rcpp::traits::input_parameter< double >::type days(daysSEXP);
     Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
-    rcpp_result_gen = Rcpp::wrap(adult_weight_wrapper_EI_fat(bw, ht, age, sex, EIchange, NAchange, PAL, pcarb_base, pcarb, dt, input_EI, input_fat, days, checkValues));
+    Rcpp::traits::input_parameter< int >::type blocksize(blocksizeSEXP);
+    Rcpp::traits::input_parameter< List >::type output(outputSEXP);
+    rcpp_result_gen = Rcpp::wrap(adult_weight_wrapper_EI_fat(bw, ht, age, sex, EIchange, NAchange, PAL, pcarb_base, pcarb, dt, input_EI, input_fat, days, checkValues, blocksize, output));
+    return rcpp_result_gen;
+END_RCPP
+}
+// api_wrapper
+List api_wrapper(List population, double days, double dt, NumericMatrix EIchange, CharacterVector variables);
+RcppExport SEXP _bw_api_wrapper(SEXP populationSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP EIchangeSEXP, SEXP variablesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type population(populationSEXP);
+    Rcpp::traits::input_parameter< double >::type days(daysSEXP);
+    Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type EIchange(EIchangeSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type variables(variablesSEXP);
+    rcpp_result_gen = Rcpp::wrap(api_wrapper(population, days, dt, EIchange, variables));
     return rcpp_result_gen;
 END_RCPP
 }
 // child_weight_wrapper
-List child_weight_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericMatrix input_EIntake, double days, double dt, bool checkValues);
-RcppExport SEXP _bw_child_weight_wrapper(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP input_EIntakeSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP) {
+List child_weight_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericMatrix input_EIntake, double days, double dt, bool checkValues, int blocksize, List output);
+RcppExport SEXP _bw_child_weight_wrapper(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP input_EIntakeSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP, SEXP blocksizeSEXP, SEXP outputSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -89,13 +110,15 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< double >::type days(daysSEXP);
     Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
     Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
-    rcpp_result_gen = Rcpp::wrap(child_weight_wrapper(age, sex, bmiCat, FFM, FM, input_EIntake, days, dt, checkValues));
+    Rcpp::traits::input_parameter< int >::type blocksize(blocksizeSEXP);
+    Rcpp::traits::input_parameter< List >::type output(outputSEXP);
+    rcpp_result_gen = Rcpp::wrap(child_weight_wrapper(age, sex, bmiCat, FFM, FM, input_EIntake, days, dt, checkValues, blocksize, output));
     return rcpp_result_gen;
 END_RCPP
 }
 // child_weight_wrapper_richardson
-List child_weight_wrapper_richardson(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, double K, double Q, double A, double B, double nu, double C, double days, double dt, bool checkValues);
-RcppExport SEXP _bw_child_weight_wrapper_richardson(SEXP ageSEXP, SEXP sexSEXP,  SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP KSEXP, SEXP QSEXP, SEXP ASEXP, SEXP BSEXP, SEXP nuSEXP, SEXP CSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP) {
+List child_weight_wrapper_richardson(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, double K, double Q, double A, double B, double nu, double C, double days, double dt, bool checkValues, int blocksize, List output);
+RcppExport SEXP _bw_child_weight_wrapper_richardson(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP KSEXP, SEXP QSEXP, SEXP ASEXP, SEXP BSEXP, SEXP nuSEXP, SEXP CSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP, SEXP blocksizeSEXP, SEXP outputSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -113,7 +136,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< double >::type days(daysSEXP);
     Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
     Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
-    rcpp_result_gen = Rcpp::wrap(child_weight_wrapper_richardson(age, sex, bmiCat, FFM, FM, K, Q, A, B, nu, C, days, dt, checkValues));
+    Rcpp::traits::input_parameter< int >::type blocksize(blocksizeSEXP);
+    Rcpp::traits::input_parameter< List >::type output(outputSEXP);
+    rcpp_result_gen = Rcpp::wrap(child_weight_wrapper_richardson(age, sex, bmiCat, FFM, FM, K, Q, A, B, nu, C, days, dt, checkValues, blocksize, output));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -147,6 +172,31 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// lttb_wrapper
+List lttb_wrapper(NumericMatrix x, NumericVector time, int points);
+RcppExport SEXP _bw_lttb_wrapper(SEXP xSEXP, SEXP timeSEXP, SEXP pointsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type time(timeSEXP);
+    Rcpp::traits::input_parameter< int >::type points(pointsSEXP);
+    rcpp_result_gen = Rcpp::wrap(lttb_wrapper(x, time, points));
+    return rcpp_result_gen;
+END_RCPP
+}
+// envelope_wrapper
+NumericMatrix envelope_wrapper(NumericMatrix x, NumericVector probs);
+RcppExport SEXP _bw_envelope_wrapper(SEXP xSEXP, SEXP probsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type probs(probsSEXP);
+    rcpp_result_gen = Rcpp::wrap(envelope_wrapper(x, probs));
+    return rcpp_result_gen;
+END_RCPP
+}
 // EnergyBuilder
 NumericMatrix EnergyBuilder(NumericMatrix Energy, NumericVector Time, std::string interpol);
 RcppExport SEXP _bw_EnergyBuilder(SEXP EnergySEXP, SEXP TimeSEXP, SEXP interpolSEXP) {
@@ -160,20 +210,330 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// group_wrapper
+List group_wrapper(List codes);
+RcppExport SEXP _bw_group_wrapper(SEXP codesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type codes(codesSEXP);
+    rcpp_result_gen = Rcpp::wrap(group_wrapper(codes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// layout_wrapper
+List layout_wrapper(List model, std::string layout);
+RcppExport SEXP _bw_layout_wrapper(SEXP modelSEXP, SEXP layoutSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< std::string >::type layout(layoutSEXP);
+    rcpp_result_gen = Rcpp::wrap(layout_wrapper(model, layout));
+    return rcpp_result_gen;
+END_RCPP
+}
+// column_wrapper
+NumericVector column_wrapper(NumericMatrix x, int j);
+RcppExport SEXP _bw_column_wrapper(SEXP xSEXP, SEXP jSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type j(jSEXP);
+    rcpp_result_gen = Rcpp::wrap(column_wrapper(x, j));
+    return rcpp_result_gen;
+END_RCPP
+}
+// row_wrapper
+NumericVector row_wrapper(NumericMatrix x, int i);
+RcppExport SEXP _bw_row_wrapper(SEXP xSEXP, SEXP iSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type i(iSEXP);
+    rcpp_result_gen = Rcpp::wrap(row_wrapper(x, i));
+    return rcpp_result_gen;
+END_RCPP
+}
+// life_course_wrapper
+List life_course_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericVector ht, NumericMatrix input_EIntake, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double days, double dt, bool checkValues);
+RcppExport SEXP _bw_life_course_wrapper(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP htSEXP, SEXP input_EIntakeSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sex(sexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type bmiCat(bmiCatSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FFM(FFMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FM(FMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type ht(htSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type input_EIntake(input_EIntakeSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type EIchange(EIchangeSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type NAchange(NAchangeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type PAL(PALSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb_base(pcarb_baseSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb(pcarbSEXP);
+    Rcpp::traits::input_parameter< double >::type days(daysSEXP);
+    Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
+    Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
+    rcpp_result_gen = Rcpp::wrap(life_course_wrapper(age, sex, bmiCat, FFM, FM, ht, input_EIntake, EIchange, NAchange, PAL, pcarb_base, pcarb, days, dt, checkValues));
+    return rcpp_result_gen;
+END_RCPP
+}
+// life_course_wrapper_reference
+List life_course_wrapper_reference(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericVector ht, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double days, double dt, bool checkValues);
+RcppExport SEXP _bw_life_course_wrapper_reference(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP htSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sex(sexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type bmiCat(bmiCatSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FFM(FFMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FM(FMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type ht(htSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type EIchange(EIchangeSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type NAchange(NAchangeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type PAL(PALSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb_base(pcarb_baseSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb(pcarbSEXP);
+    Rcpp::traits::input_parameter< double >::type days(daysSEXP);
+    Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
+    Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
+    rcpp_result_gen = Rcpp::wrap(life_course_wrapper_reference(age, sex, bmiCat, FFM, FM, ht, EIchange, NAchange, PAL, pcarb_base, pcarb, days, dt, checkValues));
+    return rcpp_result_gen;
+END_RCPP
+}
+// microsimulation_wrapper
+List microsimulation_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericVector bw, NumericVector ht, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, DataFrame entries, NumericVector exit_rate, int years, double dt, Nullable<Function> yearly, bool checkValues);
+RcppExport SEXP _bw_microsimulation_wrapper(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP bwSEXP, SEXP htSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP entriesSEXP, SEXP exit_rateSEXP, SEXP yearsSEXP, SEXP dtSEXP, SEXP yearlySEXP, SEXP checkValuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sex(sexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type bmiCat(bmiCatSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FFM(FFMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FM(FMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type bw(bwSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type ht(htSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type PAL(PALSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb_base(pcarb_baseSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb(pcarbSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type entries(entriesSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type exit_rate(exit_rateSEXP);
+    Rcpp::traits::input_parameter< int >::type years(yearsSEXP);
+    Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type yearly(yearlySEXP);
+    Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
+    rcpp_result_gen = Rcpp::wrap(microsimulation_wrapper(age, sex, bmiCat, FFM, FM, bw, ht, PAL, pcarb_base, pcarb, entries, exit_rate, years, dt, yearly, checkValues));
+    return rcpp_result_gen;
+END_RCPP
+}
+// population_wrapper
+List population_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericVector bw, NumericVector ht, NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb, double days, double dt, bool checkValues);
+RcppExport SEXP _bw_population_wrapper(SEXP ageSEXP, SEXP sexSEXP, SEXP bmiCatSEXP, SEXP FFMSEXP, SEXP FMSEXP, SEXP bwSEXP, SEXP htSEXP, SEXP EIchangeSEXP, SEXP NAchangeSEXP, SEXP PALSEXP, SEXP pcarb_baseSEXP, SEXP pcarbSEXP, SEXP daysSEXP, SEXP dtSEXP, SEXP checkValuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sex(sexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type bmiCat(bmiCatSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FFM(FFMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type FM(FMSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type bw(bwSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type ht(htSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type EIchange(EIchangeSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type NAchange(NAchangeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type PAL(PALSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb_base(pcarb_baseSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type pcarb(pcarbSEXP);
+    Rcpp::traits::input_parameter< double >::type days(daysSEXP);
+    Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
+    Rcpp::traits::input_parameter< bool >::type checkValues(checkValuesSEXP);
+    rcpp_result_gen = Rcpp::wrap(population_wrapper(age, sex, bmiCat, FFM, FM, bw, ht, EIchange, NAchange, PAL, pcarb_base, pcarb, days, dt, checkValues));
+    return rcpp_result_gen;
+END_RCPP
+}
+// replicate_wrapper
+List replicate_wrapper(NumericMatrix x, NumericMatrix weights, IntegerVector starts);
+RcppExport SEXP _bw_replicate_wrapper(SEXP xSEXP, SEXP weightsSEXP, SEXP startsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type starts(startsSEXP);
+    rcpp_result_gen = Rcpp::wrap(replicate_wrapper(x, weights, starts));
+    return rcpp_result_gen;
+END_RCPP
+}
+// shard_wrapper
+IntegerVector shard_wrapper(CharacterVector id, int shards);
+RcppExport SEXP _bw_shard_wrapper(SEXP idSEXP, SEXP shardsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type id(idSEXP);
+    Rcpp::traits::input_parameter< int >::type shards(shardsSEXP);
+    rcpp_result_gen = Rcpp::wrap(shard_wrapper(id, shards));
+    return rcpp_result_gen;
+END_RCPP
+}
+// moments_wrapper
+List moments_wrapper(NumericMatrix x, IntegerVector group, int ngroups, NumericVector weights);
+RcppExport SEXP _bw_moments_wrapper(SEXP xSEXP, SEXP groupSEXP, SEXP ngroupsSEXP, SEXP weightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type group(groupSEXP);
+    Rcpp::traits::input_parameter< int >::type ngroups(ngroupsSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weights(weightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(moments_wrapper(x, group, ngroups, weights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// shared_wrapper
+List shared_wrapper(std::string name, CharacterVector variables, bool remove);
+RcppExport SEXP _bw_shared_wrapper(SEXP nameSEXP, SEXP variablesSEXP, SEXP removeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type name(nameSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type variables(variablesSEXP);
+    Rcpp::traits::input_parameter< bool >::type remove(removeSEXP);
+    rcpp_result_gen = Rcpp::wrap(shared_wrapper(name, variables, remove));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sketch_wrapper
+List sketch_wrapper(NumericMatrix x, IntegerVector group, int ngroups, NumericVector weights, double accuracy);
+RcppExport SEXP _bw_sketch_wrapper(SEXP xSEXP, SEXP groupSEXP, SEXP ngroupsSEXP, SEXP weightsSEXP, SEXP accuracySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type group(groupSEXP);
+    Rcpp::traits::input_parameter< int >::type ngroups(ngroupsSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< double >::type accuracy(accuracySEXP);
+    rcpp_result_gen = Rcpp::wrap(sketch_wrapper(x, group, ngroups, weights, accuracy));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sketch_quantile_wrapper
+NumericMatrix sketch_quantile_wrapper(IntegerVector key, IntegerVector sign, IntegerVector index, NumericVector weight, int nkeys, NumericVector probs, double accuracy);
+RcppExport SEXP _bw_sketch_quantile_wrapper(SEXP keySEXP, SEXP signSEXP, SEXP indexSEXP, SEXP weightSEXP, SEXP nkeysSEXP, SEXP probsSEXP, SEXP accuracySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type key(keySEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type sign(signSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type nkeys(nkeysSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type probs(probsSEXP);
+    Rcpp::traits::input_parameter< double >::type accuracy(accuracySEXP);
+    rcpp_result_gen = Rcpp::wrap(sketch_quantile_wrapper(key, sign, index, weight, nkeys, probs, accuracy));
+    return rcpp_result_gen;
+END_RCPP
+}
+// precision_wrapper
+List precision_wrapper(List model, int storage, double quantum);
+RcppExport SEXP _bw_precision_wrapper(SEXP modelSEXP, SEXP storageSEXP, SEXP quantumSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< double >::type quantum(quantumSEXP);
+    rcpp_result_gen = Rcpp::wrap(precision_wrapper(model, storage, quantum));
+    return rcpp_result_gen;
+END_RCPP
+}
+// float_decode_wrapper
+NumericMatrix float_decode_wrapper(IntegerMatrix x, IntegerVector rows, IntegerVector cols);
+RcppExport SEXP _bw_float_decode_wrapper(SEXP xSEXP, SEXP rowsSEXP, SEXP colsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerMatrix >::type x(xSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type rows(rowsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type cols(colsSEXP);
+    rcpp_result_gen = Rcpp::wrap(float_decode_wrapper(x, rows, cols));
+    return rcpp_result_gen;
+END_RCPP
+}
+// delta_decode_wrapper
+NumericMatrix delta_decode_wrapper(List x, IntegerVector rows, IntegerVector cols);
+RcppExport SEXP _bw_delta_decode_wrapper(SEXP xSEXP, SEXP rowsSEXP, SEXP colsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type x(xSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type rows(rowsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type cols(colsSEXP);
+    rcpp_result_gen = Rcpp::wrap(delta_decode_wrapper(x, rows, cols));
+    return rcpp_result_gen;
+END_RCPP
+}
+// write_wrapper
+double write_wrapper(List model, std::string path, IntegerVector columns);
+RcppExport SEXP _bw_write_wrapper(SEXP modelSEXP, SEXP pathSEXP, SEXP columnsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type columns(columnsSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_wrapper(model, path, columns));
+    return rcpp_result_gen;
+END_RCPP
+}
 
+void api_init(DllInfo* dll);
+void lazy_init(DllInfo* dll);
+void shared_init(DllInfo* dll);
 static const R_CallMethodDef CallEntries[] = {
-    {"_bw_adult_weight_wrapper", (DL_FUNC) &_bw_adult_weight_wrapper, 12},
-    {"_bw_adult_weight_wrapper_EI", (DL_FUNC) &_bw_adult_weight_wrapper_EI, 14},
-    {"_bw_adult_weight_wrapper_EI_fat", (DL_FUNC) &_bw_adult_weight_wrapper_EI_fat, 14},
-    {"_bw_child_weight_wrapper", (DL_FUNC) &_bw_child_weight_wrapper, 9},
-    {"_bw_child_weight_wrapper_richardson", (DL_FUNC) &_bw_child_weight_wrapper_richardson, 14},
+    {"_bw_adult_weight_wrapper", (DL_FUNC) &_bw_adult_weight_wrapper, 14},
+    {"_bw_adult_weight_wrapper_EI", (DL_FUNC) &_bw_adult_weight_wrapper_EI, 16},
+    {"_bw_adult_weight_wrapper_EI_fat", (DL_FUNC) &_bw_adult_weight_wrapper_EI_fat, 16},
+    {"_bw_api_wrapper", (DL_FUNC) &_bw_api_wrapper, 5},
+    {"_bw_child_weight_wrapper", (DL_FUNC) &_bw_child_weight_wrapper, 11},
+    {"_bw_child_weight_wrapper_richardson", (DL_FUNC) &_bw_child_weight_wrapper_richardson, 16},
     {"_bw_intake_reference_wrapper", (DL_FUNC) &_bw_intake_reference_wrapper, 7},
     {"_bw_mass_reference_wrapper", (DL_FUNC) &_bw_mass_reference_wrapper, 3},
+    {"_bw_lttb_wrapper", (DL_FUNC) &_bw_lttb_wrapper, 3},
+    {"_bw_envelope_wrapper", (DL_FUNC) &_bw_envelope_wrapper, 2},
     {"_bw_EnergyBuilder", (DL_FUNC) &_bw_EnergyBuilder, 3},
+    {"_bw_group_wrapper", (DL_FUNC) &_bw_group_wrapper, 1},
+    {"_bw_layout_wrapper", (DL_FUNC) &_bw_layout_wrapper, 2},
+    {"_bw_column_wrapper", (DL_FUNC) &_bw_column_wrapper, 2},
+    {"_bw_row_wrapper", (DL_FUNC) &_bw_row_wrapper, 2},
+    {"_bw_life_course_wrapper", (DL_FUNC) &_bw_life_course_wrapper, 15},
+    {"_bw_life_course_wrapper_reference", (DL_FUNC) &_bw_life_course_wrapper_reference, 14},
+    {"_bw_microsimulation_wrapper", (DL_FUNC) &_bw_microsimulation_wrapper, 16},
+    {"_bw_population_wrapper", (DL_FUNC) &_bw_population_wrapper, 15},
+    {"_bw_replicate_wrapper", (DL_FUNC) &_bw_replicate_wrapper, 3},
+    {"_bw_shard_wrapper", (DL_FUNC) &_bw_shard_wrapper, 2},
+    {"_bw_moments_wrapper", (DL_FUNC) &_bw_moments_wrapper, 4},
+    {"_bw_shared_wrapper", (DL_FUNC) &_bw_shared_wrapper, 3},
+    {"_bw_sketch_wrapper", (DL_FUNC) &_bw_sketch_wrapper, 5},
+    {"_bw_sketch_quantile_wrapper", (DL_FUNC) &_bw_sketch_quantile_wrapper, 7},
+    {"_bw_precision_wrapper", (DL_FUNC) &_bw_precision_wrapper, 3},
+    {"_bw_float_decode_wrapper", (DL_FUNC) &_bw_float_decode_wrapper, 3},
+    {"_bw_delta_decode_wrapper", (DL_FUNC) &_bw_delta_decode_wrapper, 3},
+    {"_bw_write_wrapper", (DL_FUNC) &_bw_write_wrapper, 3},
     {NULL, NULL, 0}
 };
 
 RcppExport void R_init_bw(DllInfo *dll) {
     R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
+    api_init(dll);
+    lazy_init(dll);
+    shared_init(dll);
 }
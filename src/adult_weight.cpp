@@ -63,6 +63,7 @@
 //----------------------------------------------------------------------------------------
 
 #include "adult_weight.h"
+#include "tiles.h"
 
 //Default Constructor for an Adult.
 Adult::Adult(NumericVector weight, NumericVector height, NumericVector age_yrs,
@@ -226,6 +227,8 @@ Adult::~Adult(void){
 
 void Adult::getParameters(void){
     
+    PROFILE_SCOPE("getParameters");
+    
     //Get size of model
     nind    = bw.size();
     
@@ -377,6 +380,8 @@ NumericVector Adult::R(double t, NumericVector L, NumericVector G,
 
 //Classifier for bMI
 StringVector Adult::BMIClassifier(NumericVector BMI){
+    
+    PROFILE_SCOPE("bmi_category");
     StringVector classification(BMI.size());
     /*for(int i = 0; i < BMI.size(); i++){
         classification(i) = "Unknown";
@@ -415,127 +420,295 @@ StringVector Adult::BMIClassifier(NumericVector BMI){
 
 
 //Rungue Kutta 4 method for Adult
-List Adult::rk4(double days){
-    
-    //Initial TIME(i-1)
-    NumericVector k1, k2, k3, k4;
+List Adult::rk4(double days, Output output){
     
     //Estimate number of elements to loop into
     const int nsims = std::min(ceil(days/dt), EIchange.nrow() - 1.0);
     
-    NumericMatrix AT(nind, nsims + 1); //in rcpp
-    NumericMatrix ECF(nind, nsims + 1); //in rcpp
-    NumericMatrix GLY(nind, nsims + 1); //in rcpp
-    NumericMatrix L(nind, nsims + 1); //in rcpp
-    NumericMatrix F(nind, nsims + 1); //in rcpp
-    NumericMatrix BW(nind, nsims + 1); //in rcpp
-    NumericMatrix BMI(nind, nsims + 1); //in rcpp
-    NumericMatrix TEI(nind, nsims + 1); //in rcpp
-    NumericMatrix AGE(nind, nsims + 1); //in rcpp
-    StringMatrix CAT(nind, nsims + 1); //in rcpp
+    //Results (only the recorded variables are stored)
+    Trajectory AT(nind, nsims + 1, output, "Adaptive_Thermogenesis"); //in rcpp
+    Trajectory ECF(nind, nsims + 1, output, "Extracellular_Fluid"); //in rcpp
+    Trajectory GLY(nind, nsims + 1, output, "Glycogen"); //in rcpp
+    Trajectory L(nind, nsims + 1, output, "Lean_Mass"); //in rcpp
+    Trajectory F(nind, nsims + 1, output, "Fat_Mass"); //in rcpp
+    Trajectory BW(nind, nsims + 1, output, "Body_Weight"); //in rcpp
+    Trajectory BMI(nind, nsims + 1, output, "Body_Mass_Index", BW.records()); //lazy: BW/ht^2
+    Trajectory TEI(nind, nsims + 1, output, "Energy_Intake"); //in rcpp
+    Trajectory AGE(nind, nsims + 1, output, "Age", true); //lazy: age + i*dt/365
+    bool recordCAT = output.records("BMI_Category") && output.matrices();
+    int  ncols     = output.columns(nsims + 1);
+    StringMatrix CAT(recordCAT ? nind : 0, recordCAT ? ncols : 0); //in rcpp
     
     NumericVector TIME(nsims + 1); //in rcpp
     
+    //Rolling values (in double precision)
+    NumericVector AGEi = clone(age);
+    NumericVector Fi   = fatMass(lean);
+    NumericVector BWi  = clone(bw);
+    NumericVector BMIi = bw/pow(ht,2.0);
+    
     //Create initial states in rcpp
-    AT(_,0)  = atinit;
-    ECF(_,0) = ecfinit;
-    GLY(_,0) = G_base;
-    L(_,0)   = lean;
-    F(_,0)   = fatMass(lean);
-    BW(_,0)  = bw;
-    BMI(_,0) = bw/pow(ht,2.0);
-    CAT(_,0) = BMIClassifier(BMI(_,0));
-    TEI(_,0) = EI;
+    AT.set(0, atinit);
+    ECF.set(0, ecfinit);
+    GLY.set(0, G_base);
+    L.set(0, lean);
+    F.set(0, Fi);
+    BW.set(0, BWi);
+    BMI.set(0, BMIi);
+    if (recordCAT){
+        CAT(_,0) = BMIClassifier(BMIi);
+    }
+    if (output.transitions){
+        output.transitions->classify(0, output.first, BMIi);
+    }
+    TEI.set(0, EI);
     TIME(0)  = 0.0;
-    AGE(_,0) = age;
+    AGE.set(0, AGEi);
     
     
+    //Rolling state: adaptive thermogenesis, extracellular fluid, glycogen and lean mass
+    NumericMatrix State = initState();
+    
     //Loop through all other states
     bool correctVals = true;
+    int  completed   = nsims; //Last time step (before if the run is cancelled)
     for (int i = 1; i <= nsims; i++){
         
-        
-        //Adaptive thermogenesis
-        k1 = dAT(TIME(i-1), AT(_, i-1)); // f(t_n , y_n)
-        k2 = dAT(TIME(i-1) + 0.5 * dt, AT(_, i-1) + 0.5 * dt * k1); // f(t_n + h/2, y_n + h/2 k1)
-        k3 = dAT(TIME(i-1) + 0.5 * dt, AT(_, i-1) + 0.5 * dt * k2); // f(t_n + h/2, y_n + h/2 k2)
-        k4 = dAT(TIME(i-1) + dt, AT(_, i-1) + dt * k3); // f(t_n + h, y_n + h k3)
-        
-        //Update AT
-        AT(_,i) = AT(_, i-1) + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
-        
-        //Extracellular fluid
-        k1 = dECF(TIME(i-1), ECF(_, i-1)); // f(t_n , y_n)
-        k2 = dECF(TIME(i-1) + 0.5 * dt, ECF(_, i-1) + 0.5 * dt * k1); // f(t_n + h/2, y_n + h/2 k1)
-        k3 = dECF(TIME(i-1) + 0.5 * dt, ECF(_, i-1) + 0.5 * dt * k2); // f(t_n + h/2, y_n + h/2 k2)
-        k4 = dECF(TIME(i-1) + dt, ECF(_, i-1) + dt * k3); // f(t_n + h, y_n + h k3)
-        
-        //Update ECF
-        ECF(_,i) = ECF(_, i-1) + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
-        
-        //Glycogen
-        k1 = dG(TIME(i-1), GLY(_, i-1));
-        k2 = dG(TIME(i-1) + 0.5 * dt, GLY(_, i-1) + 0.5 * dt * k1);
-        k3 = dG(TIME(i-1) + 0.5 * dt, GLY(_, i-1) + 0.5 * dt * k2);
-        k4 = dG(TIME(i-1) + dt, GLY(_, i-1) + dt * k3);
-        
-        //Update Glycogen
-        GLY(_,i) = GLY(_, i-1) + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
-        
-        //Lean Mass
-        k1 = dL(TIME(i-1) , L(_, i-1), GLY(_, i-1), AT(_, i-1), ECF(_, i-1));
-        k2 = dL(TIME(i-1) + 0.5 * dt, L(_, i-1) + 0.5 * dt * k1, 0.5*(GLY(_, i) + GLY(_, i-1)),
-                0.5*(AT(_,i) + AT(_, i-1)), 0.5*(ECF(_,i) +ECF(_,i-1)));
-        k3 = dL(TIME(i-1) + 0.5 * dt, L(_, i-1) + 0.5 * dt * k2, 0.5*(GLY(_,i) + GLY(_, i-1)),
-                0.5*(AT(_,i) + AT(_, i-1)), 0.5*(ECF(_,i) + ECF(_,i-1)));
-        k4 = dL(TIME(i-1) + dt, L(_, i-1) + dt*k3, GLY(_,i), AT(_,i), ECF(_,i));
-        
-        //Update L
-        L(_,i) = L(_, i-1) + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
+        //Rungue kutta 4 step from previous state
+        State   = rk4_step(TIME(i-1), State);
+        NumericVector Li = State(3,_);
+        AT.set(i, State(0,_));
+        ECF.set(i, State(1,_));
+        GLY.set(i, State(2,_));
+        L.set(i, Li);
         
         //Update F
-        F(_,i) = fatMass(L(_,i));
+        Fi = fatMass(Li);
+        F.set(i, Fi);
         
         //Update bw
-        BW(_,i) = F(_,i) + L(_,i) + ECF(_,i) + 3.7*GLY(_,i);
+        BWi = Fi + Li + State(1,_) + 3.7*State(2,_);
+        BW.set(i, BWi);
         
         //Update BMI
-        BMI(_,i) = BW(_,i)/pow(ht,2.0);
+        BMIi = BWi/pow(ht,2.0);
+        BMI.set(i, BMIi);
         
         //Classify BMI
-        CAT(_,i) = BMIClassifier(BMI(_,i));
+        if (recordCAT && output.column(i) >= 0){
+            CAT(_,output.column(i)) = BMIClassifier(BMIi);
+        }
+        if (output.transitions){
+            output.transitions->classify(i, output.first, BMIi);
+        }
         
         //Update TIME(i-1)
         TIME(i) = TIME(i-1) + dt;
         
         //Update age
-        AGE(_,i) = AGE(_,i-1) + dt/365.0;
+        AGEi = AGEi + dt/365.0;
+        AGE.set(i, AGEi);
         
         //Get energy intake
-        TEI(_,i) = TotalIntake(TIME(i));
+        if (TEI.records()){
+            TEI.set(i, TotalIntake(TIME(i)));
+        }
+        
+        //Report progress; a cancelled run returns the time steps done so far
+        if (!output.proceed(i, nsims, nind)){
+            completed = i;
+            break;
+        }
         
     }
     
-    return List::create(Named("Time") = TIME,
-                        Named("Age") = AGE,
-                        Named("Adaptive_Thermogenesis") = AT,
-                        Named("Extracellular_Fluid") = ECF,
-                        Named("Glycogen") = GLY,
-                        Named("Fat_Mass") = F,
-                        Named("Lean_Mass")   = L,
-                        Named("Body_Weight") = BW,
-                        Named("Body_Mass_Index") = BMI,
-                        Named("BMI_Category") = CAT,
-                        Named("Energy_Intake") = TEI,
-                        Named("Correct_Values")=correctVals,
-                        Named("Model_Type")="Adult");
+    //Derived results are computed when read
+    PROFILE_SCOPE("results");
+    RObject ResultAGE = AGE.lazy() ?
+        lazy_age(clone(age), output.every*dt/365.0, ncols) : AGE.result();
+    RObject ResultBMI = BMI.lazy() ?
+        lazy_ratio(NumericMatrix(BW.result()), NumericVector(pow(ht,2.0))) : BMI.result();
+    
+    return recorded(List::create(Named("Time") = output.times(TIME),
+                                 Named("Age") = ResultAGE,
+                                 Named("Adaptive_Thermogenesis") = AT.result(),
+                                 Named("Extracellular_Fluid") = ECF.result(),
+                                 Named("Glycogen") = GLY.result(),
+                                 Named("Fat_Mass") = F.result(),
+                                 Named("Lean_Mass")   = L.result(),
+                                 Named("Body_Weight") = BW.result(),
+                                 Named("Body_Mass_Index") = ResultBMI,
+                                 Named("BMI_Category") = recordCAT ? (SEXP) CAT : R_NilValue,
+                                 Named("BMI_Transitions") = output.transitions ?
+                                     (SEXP) output.transitions->result() : R_NilValue,
+                                 Named("Energy_Intake") = TEI.result(),
+                                 Named("Correct_Values")=correctVals,
+                                 Named("Model_Type")="Adult",
+                                 Named("Interrupted") = completed < nsims ?
+                                     (SEXP) interrupted(nind, output.columns(completed + 1)) : R_NilValue));
     
 }
 
 
 
+//Rungue Kutta 4 method by blocks of blocksize individuals. Each block is run
+//through all the days before the next one starts.
+List Adult::rk4_tiled(double days, int blocksize, Output output){
+    
+    output.population = nind;
+    if (blocksize <= 0 || blocksize >= nind){
+        List Model = rk4(days, output);
+        output.close();
+        return Model;
+    }
+    
+    List Model;
+    for (int start = 0; start < nind; start += blocksize){
+        int end    = std::min(start + blocksize, nind);
+        Output blockoutput = output;
+        blockoutput.first  = output.first + start;
+        List Block = block(start, end).rk4(days, blockoutput);
+        if (Block.containsElementNamed("Interrupted")){
+            Model = start == 0 ? Block : interrupted_tiles(Model, start, nind);
+            break;
+        }
+        if (start == 0){
+            Model = allocate_tiles(Block, nind);
+        }
+        copy_tile(Model, Block, start);
+    }
+    output.close();
+    
+    return Model;
+}
+
+//Adults in positions start to end - 1. The baseline energy intake and fat
+//are passed so that the block has the same baseline as the whole model.
+Adult Adult::block(int start, int end){
+    return select(seq(start, end - 1));
+}
+
+//Adults in the given positions (from 0) with the baseline of the whole model
+Adult Adult::select(IntegerVector rows){
+    
+    NumericVector block_bw         = bw[rows];
+    NumericVector block_ht         = ht[rows];
+    NumericVector block_age        = age[rows];
+    NumericVector block_sex        = sex[rows];
+    NumericVector block_PAL        = PAL[rows];
+    NumericVector block_pcarb      = pcarb[rows];
+    NumericVector block_pcarb_base = pcarb_base[rows];
+    NumericVector block_EI         = EI[rows];
+    NumericVector block_fat        = fat[rows];
+    
+    return Adult(block_bw, block_ht, block_age, block_sex, column_select(EIchange, rows),
+                 column_select(NAchange, rows), block_PAL, block_pcarb, block_pcarb_base,
+                 dt, block_EI, block_fat, check);
+}
+
+//Single Rungue Kutta 4 step for Adult starting at time t. State is a matrix whose rows
+//are the adaptive thermogenesis, extracellular fluid, glycogen and lean mass of each
+//individual (columns). Returns the state after dt.
+NumericMatrix Adult::rk4_step(double t, NumericMatrix State){
+    
+    PROFILE_SCOPE("rk4_step");
+    PROFILE_COUNT("rhs_evaluations", 4.0*nind); //k1 to k4 of each individual
+    
+    NumericVector k1, k2, k3, k4;
+    NumericMatrix NewState(4, nind);
+    
+    NumericVector AT0  = State(0,_);
+    NumericVector ECF0 = State(1,_);
+    NumericVector GLY0 = State(2,_);
+    NumericVector L0   = State(3,_);
+    
+    //Adaptive thermogenesis
+    k1 = dAT(t, AT0); // f(t_n , y_n)
+    k2 = dAT(t + 0.5 * dt, AT0 + 0.5 * dt * k1); // f(t_n + h/2, y_n + h/2 k1)
+    k3 = dAT(t + 0.5 * dt, AT0 + 0.5 * dt * k2); // f(t_n + h/2, y_n + h/2 k2)
+    k4 = dAT(t + dt, AT0 + dt * k3); // f(t_n + h, y_n + h k3)
+    
+    //Update AT
+    NumericVector AT1 = AT0 + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
+    
+    //Extracellular fluid
+    k1 = dECF(t, ECF0); // f(t_n , y_n)
+    k2 = dECF(t + 0.5 * dt, ECF0 + 0.5 * dt * k1); // f(t_n + h/2, y_n + h/2 k1)
+    k3 = dECF(t + 0.5 * dt, ECF0 + 0.5 * dt * k2); // f(t_n + h/2, y_n + h/2 k2)
+    k4 = dECF(t + dt, ECF0 + dt * k3); // f(t_n + h, y_n + h k3)
+    
+    //Update ECF
+    NumericVector ECF1 = ECF0 + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
+    
+    //Glycogen
+    k1 = dG(t, GLY0);
+    k2 = dG(t + 0.5 * dt, GLY0 + 0.5 * dt * k1);
+    k3 = dG(t + 0.5 * dt, GLY0 + 0.5 * dt * k2);
+    k4 = dG(t + dt, GLY0 + dt * k3);
+    
+    //Update Glycogen
+    NumericVector GLY1 = GLY0 + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
+    
+    //Lean Mass
+    k1 = dL(t, L0, GLY0, AT0, ECF0);
+    k2 = dL(t + 0.5 * dt, L0 + 0.5 * dt * k1, 0.5*(GLY1 + GLY0),
+            0.5*(AT1 + AT0), 0.5*(ECF1 + ECF0));
+    k3 = dL(t + 0.5 * dt, L0 + 0.5 * dt * k2, 0.5*(GLY1 + GLY0),
+            0.5*(AT1 + AT0), 0.5*(ECF1 + ECF0));
+    k4 = dL(t + dt, L0 + dt*k3, GLY1, AT1, ECF1);
+    
+    //Update L
+    NewState(0,_) = AT1;
+    NewState(1,_) = ECF1;
+    NewState(2,_) = GLY1;
+    NewState(3,_) = L0 + dt * (k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
+    
+    return NewState;
+}
+
+//Re-estimates the baseline of the individuals flagged in which using their current
+//weight, age and fat mass (energy balance at the new baseline is assumed). This is used
+//when a child enters the adult model. Returns the initial state (see rk4_step) of
+//every individual; only the flagged columns correspond to the new baseline.
+NumericMatrix Adult::rebase(LogicalVector which, NumericVector weight, NumericVector age_yrs,
+                            NumericVector input_fat){
+    
+    //Update baseline values only for flagged individuals. New vectors are
+    //assigned as bw, age and fat may share memory with the inputs from R.
+    NumericVector new_bw  = ifelse(which, weight, bw);
+    NumericVector new_age = ifelse(which, age_yrs, age);
+    NumericVector new_fat = ifelse(which, input_fat, fat);
+    bw  = new_bw;
+    age = new_age;
+    fat = new_fat;
+    
+    //Recompute the parameters that depend on the baseline
+    getRMR();
+    getATinit();
+    getECFinit();
+    getCaloricSteadyState();
+    getEnergy();
+    lean = bw - (ecfinit + fat + 3.7*G_base);
+    getDelta();
+    getK();
+    getCarbConstants();
+    
+    return initState();
+}
+
+//Initial state (see rk4_step) of every individual
+NumericMatrix Adult::initState(void){
+    NumericMatrix State(4, nind);
+    State(0,_) = atinit;
+    State(1,_) = ecfinit;
+    State(2,_) = G_base;
+    State(3,_) = lean;
+    return State;
+}
+
 //Change in calories
 NumericVector Adult::deltaEI(double t){
+    PROFILE_SCOPE("intake");
     return EIchange(floor(t/dt),_);
 }
 
@@ -32,6 +32,9 @@
 
 #include <math.h>
 #include <Rcpp.h>
+#include "trajectory.h"
+#include "lazy.h"
+#include "profile.h"
 using namespace Rcpp;
 
 //Create a Adult class to contain individual parameters
@@ -87,7 +90,15 @@ public:
     
     //Functions
     //---------------------------------------------------------------------------
-    List rk4(double days); //in Rcpp:
+    List rk4(double days, Output output = Output()); //in Rcpp:
+    List rk4_tiled(double days, int blocksize, Output output = Output());
+    NumericMatrix rk4_step(double t, NumericMatrix State);
+    Adult block(int start, int end);
+    Adult select(IntegerVector rows);
+    NumericMatrix initState(void);
+    NumericMatrix rebase(LogicalVector which, NumericVector weight, NumericVector age_yrs,
+                         NumericVector input_fat);
+    NumericVector fatMass(NumericVector L);
     
 private:
     
@@ -156,7 +167,6 @@ private:
     NumericVector CI(double t);
     NumericVector R(double t, NumericVector L, NumericVector G,
                     NumericVector AT, NumericVector ECF);
-    NumericVector fatMass(NumericVector L);
     NumericVector deltaEI(double t);
     NumericVector deltaNA(double t);
     NumericVector TEF(double t);
@@ -70,13 +70,15 @@ List adult_weight_wrapper(NumericVector bw, NumericVector ht, NumericVector age,
                           NumericVector sex, NumericMatrix EIchange,
                           NumericMatrix NAchange, NumericVector PAL,
                           NumericVector pcarb_base, NumericVector pcarb, double dt,
-                          double days, bool checkValues){
+                          double days, bool checkValues, int blocksize, List output){
+    
+    profile_reset();
     
     //Create new adult with characteristics
     Adult Person (bw,  ht, age, sex, EIchange, NAchange, PAL, pcarb,  pcarb_base, dt, checkValues);
     
     //Run model using RK4
-    return Person.rk4(days);
+    return profile_result(Person.rk4_tiled(days, blocksize, Output(output)));
     
 }
 
@@ -85,13 +87,15 @@ List adult_weight_wrapper_EI(NumericVector bw, NumericVector ht, NumericVector a
                           NumericVector sex, NumericMatrix EIchange,
                           NumericMatrix NAchange, NumericVector PAL,
                           NumericVector pcarb_base, NumericVector pcarb, double dt,
-                             NumericVector extradata, double days, bool checkValues, bool isEnergy){
+                             NumericVector extradata, double days, bool checkValues, bool isEnergy, int blocksize, List output){
+    
+    profile_reset();
     
     //Create new adult with characteristics
     Adult Person (bw,  ht, age, sex, EIchange, NAchange, PAL, pcarb,  pcarb_base, dt, extradata, checkValues, isEnergy);
     
     //Run model using RK4
-    return Person.rk4(days);
+    return profile_result(Person.rk4_tiled(days, blocksize, Output(output)));
     
 }
 
@@ -101,12 +105,14 @@ List adult_weight_wrapper_EI_fat(NumericVector bw, NumericVector ht, NumericVect
                              NumericMatrix NAchange, NumericVector PAL,
                              NumericVector pcarb_base, NumericVector pcarb, double dt,
                              NumericVector input_EI, NumericVector input_fat,
-                                 double days, bool checkValues){
+                                 double days, bool checkValues, int blocksize, List output){
+    
+    profile_reset();
     
     //Create new adult with characteristics
     Adult Person (bw,  ht, age, sex, EIchange, NAchange, PAL, pcarb,  pcarb_base, dt, input_EI, input_fat, checkValues);
     
     //Run model using RK4
-    return Person.rk4(days);
+    return profile_result(Person.rk4_tiled(days, blocksize, Output(output)));
     
 }
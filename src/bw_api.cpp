@@ -0,0 +1,292 @@
+//
+//  bw_api.cpp
+//
+//  C interface of the models for callers in the R session that loaded bw
+//  (see inst/include/bw_api.h). The handles keep the caller's arrays; a run
+//  copies them into R vectors, runs the models of the package on them and
+//  copies the results to the caller's buffers.
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <string.h>
+#include <Rcpp.h>
+#include "adult_weight.h"
+#include "child_weight.h"
+#include "../inst/include/bw_api.h"
+using namespace Rcpp;
+
+enum PopulationKind {
+    ADULT_POPULATION = 0,
+    CHILD_POPULATION = 1
+};
+
+struct bw_population {
+    int kind;
+    int nind;
+    const double* bw;
+    const double* ht;
+    const double* age;
+    const double* sex;
+    const double* PAL;
+    const double* pcarb_base;
+    const double* pcarb;
+    const double* bmiCat;
+    const double* FFM;
+    const double* FM;
+};
+
+struct bw_scenario {
+    double        days;
+    double        dt;
+    int           nsteps;
+    const double* EIchange;
+    const double* NAchange;
+};
+
+//Vector or matrix (nrow x ncol) with a copy of an array (zeros if NULL)
+static NumericVector api_vector(const double* x, int n){
+    NumericVector values(n);
+    if (x != NULL){
+        std::copy(x, x + n, values.begin());
+    }
+    return values;
+}
+
+static NumericMatrix api_matrix(const double* x, int nrow, int ncol){
+    NumericMatrix values(nrow, ncol);
+    if (x != NULL){
+        std::copy(x, x + (size_t) nrow*ncol, values.begin());
+    }
+    return values;
+}
+
+//Time steps that a run records (as Adult::rk4 and the child_weight wrapper,
+//where days counts the first day); -1 if the scenario is too short for them
+static int api_ntimes(const bw_population* population, const bw_scenario* scenario){
+    double steps = population->kind == ADULT_POPULATION ?
+        ceil(scenario->days/scenario->dt) : floor((scenario->days - 1)/scenario->dt);
+    if (steps < 0 || steps + 1 > scenario->nsteps){
+        return -1;
+    }
+    return (int) steps + 1;
+}
+
+//Run of bw_run. It is called through R_ToplevelExec so that an R error (a
+//longjmp that C++ cannot catch) ends the run instead of the caller.
+struct api_run {
+    const bw_population* population;
+    const bw_scenario*   scenario;
+    bw_buffer*           buffers;
+    int                  nbuffers;
+    int*                 ntimes;
+    int                  status;
+};
+
+static void api_run_model(void* data){
+
+    api_run* run = (api_run*) data;
+#ifdef RCPP_USING_UNWIND_PROTECT
+    SEXP jump = NULL;
+#endif
+    const bw_population* population = run->population;
+    const bw_scenario*   scenario   = run->scenario;
+    bw_buffer*           buffers    = run->buffers;
+    int                  nbuffers   = run->nbuffers;
+
+    try {
+        int nind = population->nind;
+
+        //Only the variables of the buffers are recorded
+        CharacterVector variables(nbuffers);
+        for (int k = 0; k < nbuffers; k++){
+            if (buffers[k].variable == NULL || buffers[k].values == NULL ||
+                strcmp(buffers[k].variable, "BMI_Category") == 0){
+                run->status = BW_ERROR_VARIABLE;
+                return;
+            }
+            variables(k) = buffers[k].variable;
+        }
+        Output output(List::create(Named("storage")   = (int) DOUBLE_STORAGE,
+                                   Named("quantum")   = DELTA_QUANTUM,
+                                   Named("variables") = variables,
+                                   Named("sink")      = (int) FULL_SINK,
+                                   Named("every")     = 1,
+                                   Named("file")      = ""));
+
+        //The models take the changes with a row for each time step
+        NumericMatrix EIchange = api_matrix(scenario->EIchange, scenario->nsteps, nind);
+        NumericMatrix NAchange = api_matrix(scenario->NAchange, scenario->nsteps, nind);
+
+        List model;
+        if (population->kind == ADULT_POPULATION){
+            NumericVector PAL        = population->PAL == NULL ?
+                NumericVector(nind, 1.5) : api_vector(population->PAL, nind);
+            NumericVector pcarb_base = population->pcarb_base == NULL ?
+                NumericVector(nind, 0.5) : api_vector(population->pcarb_base, nind);
+            NumericVector pcarb      = population->pcarb == NULL ?
+                clone(pcarb_base) : api_vector(population->pcarb, nind);
+            Adult Person(api_vector(population->bw, nind), api_vector(population->ht, nind),
+                         api_vector(population->age, nind), api_vector(population->sex, nind),
+                         EIchange, NAchange, PAL, pcarb, pcarb_base, scenario->dt, true);
+            model = Person.rk4_tiled(scenario->days, 0, output);
+        } else {
+            Child Person(api_vector(population->age, nind), api_vector(population->sex, nind),
+                         api_vector(population->bmiCat, nind), api_vector(population->FFM, nind),
+                         api_vector(population->FM, nind), EIchange, scenario->dt, true, true);
+            model = Person.rk4_tiled(scenario->days - 1, 0, output);
+        }
+
+        if (!as<bool>(model["Correct_Values"])){
+            run->status = BW_ERROR_MODEL;
+            return;
+        }
+
+        //Copy the results to the buffers
+        *run->ntimes = Rf_length(model["Time"]);
+        for (int k = 0; k < nbuffers; k++){
+            if (!model.containsElementNamed(buffers[k].variable) ||
+                !Rf_isMatrix(model[buffers[k].variable])){
+                run->status = BW_ERROR_VARIABLE;
+                return;
+            }
+            NumericMatrix values = model[buffers[k].variable];
+            std::copy(values.begin(), values.end(), buffers[k].values);
+        }
+        run->status = BW_OK;
+#ifdef RCPP_USING_UNWIND_PROTECT
+    } catch (Rcpp::LongjumpException& error){
+        run->status = BW_ERROR_MODEL;
+        jump        = error.token;
+#endif
+    } catch (...){
+        run->status = BW_ERROR_MODEL;
+    }
+
+    //An R error continues to R_ToplevelExec once the C++ objects of the run
+    //are destroyed (Rcpp preserved its token when it stopped the error)
+#ifdef RCPP_USING_UNWIND_PROTECT
+    if (jump != NULL){
+        R_ReleaseObject(jump);
+        R_ContinueUnwind(jump);
+    }
+#endif
+}
+
+extern "C" {
+
+static int bw_api_version_impl(void){
+    return BW_API_VERSION;
+}
+
+static bw_population* bw_adult_population_impl(int nind, const double* bw, const double* ht,
+                                                const double* age, const double* sex,
+                                                const double* PAL, const double* pcarb_base,
+                                                const double* pcarb){
+    if (nind <= 0 || bw == NULL || ht == NULL || age == NULL || sex == NULL){
+        return NULL;
+    }
+    bw_population* population = new bw_population();
+    population->kind       = ADULT_POPULATION;
+    population->nind       = nind;
+    population->bw         = bw;
+    population->ht         = ht;
+    population->age        = age;
+    population->sex        = sex;
+    population->PAL        = PAL;
+    population->pcarb_base = pcarb_base;
+    population->pcarb      = pcarb;
+    return population;
+}
+
+static bw_population* bw_child_population_impl(int nind, const double* age, const double* sex,
+                                                const double* bmiCat, const double* FFM,
+                                                const double* FM){
+    if (nind <= 0 || age == NULL || sex == NULL || bmiCat == NULL || FFM == NULL || FM == NULL){
+        return NULL;
+    }
+    bw_population* population = new bw_population();
+    population->kind   = CHILD_POPULATION;
+    population->nind   = nind;
+    population->age    = age;
+    population->sex    = sex;
+    population->bmiCat = bmiCat;
+    population->FFM    = FFM;
+    population->FM     = FM;
+    return population;
+}
+
+static void bw_population_free_impl(bw_population* population){
+    delete population;
+}
+
+static bw_scenario* bw_scenario_impl(double days, double dt, int nsteps,
+                                     const double* EIchange, const double* NAchange){
+    if (days <= 0 || dt <= 0 || dt > days || nsteps < 1){
+        return NULL;
+    }
+    bw_scenario* scenario = new bw_scenario();
+    scenario->days     = days;
+    scenario->dt       = dt;
+    scenario->nsteps   = nsteps;
+    scenario->EIchange = EIchange;
+    scenario->NAchange = NAchange;
+    return scenario;
+}
+
+static void bw_scenario_free_impl(bw_scenario* scenario){
+    delete scenario;
+}
+
+static int bw_run_impl(const bw_population* population, const bw_scenario* scenario,
+                       bw_buffer* buffers, int nbuffers, int nthreads, int* ntimes){
+
+    if (population == NULL || scenario == NULL || (buffers == NULL && nbuffers > 0) ||
+        nbuffers < 0 || ntimes == NULL || api_ntimes(population, scenario) < 0){
+        return BW_ERROR_ARGUMENT;
+    }
+    if (nthreads != 1){
+        return BW_ERROR_THREADS;
+    }
+
+    api_run run = {population, scenario, buffers, nbuffers, ntimes, BW_ERROR_MODEL};
+    if (!R_ToplevelExec(api_run_model, &run)){
+        return BW_ERROR_MODEL;
+    }
+
+    return run.status;
+}
+
+}
+
+//Register the C interface for other packages (R_GetCCallable)
+// [[Rcpp::init]]
+void api_init(DllInfo* dll){
+    R_RegisterCCallable("bw", "bw_api_version",      (DL_FUNC) bw_api_version_impl);
+    R_RegisterCCallable("bw", "bw_adult_population", (DL_FUNC) bw_adult_population_impl);
+    R_RegisterCCallable("bw", "bw_child_population", (DL_FUNC) bw_child_population_impl);
+    R_RegisterCCallable("bw", "bw_population_free",  (DL_FUNC) bw_population_free_impl);
+    R_RegisterCCallable("bw", "bw_scenario",         (DL_FUNC) bw_scenario_impl);
+    R_RegisterCCallable("bw", "bw_scenario_free",    (DL_FUNC) bw_scenario_free_impl);
+    R_RegisterCCallable("bw", "bw_run",              (DL_FUNC) bw_run_impl);
+}
@@ -0,0 +1,85 @@
+//
+//  bw_api_wrapper.cpp
+//
+//  This is a function that runs a model through the C interface of the
+//  package (inst/include/bw_api.h) looking its functions up with
+//  R_GetCCallable, as a package that links to bw would. It is used by
+//  the tests of the interface.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <Rcpp.h>
+#include "../inst/include/bw_api.h"
+using namespace Rcpp;
+
+//Population with the bw of adults (or the bmiCat, FFM and FM of children), the
+//nsteps x nind changes of energy intake and the variables of the buffers. The
+//buffers have room for nsteps time steps; only the ntimes written are returned.
+// [[Rcpp::export]]
+List api_wrapper(List population, double days, double dt, NumericMatrix EIchange,
+                 CharacterVector variables){
+
+    NumericVector age  = population["age"];
+    NumericVector sex  = population["sex"];
+    int           nind = age.size();
+    int         nsteps = EIchange.nrow();
+
+    bw_population* people;
+    if (population.containsElementNamed("bw")){
+        NumericVector bw = population["bw"];
+        NumericVector ht = population["ht"];
+        people = bw_adult_population(nind, bw.begin(), ht.begin(), age.begin(), sex.begin(),
+                                     NULL, NULL, NULL);
+    } else {
+        NumericVector bmiCat = population["bmiCat"];
+        NumericVector FFM    = population["FFM"];
+        NumericVector FM     = population["FM"];
+        people = bw_child_population(nind, age.begin(), sex.begin(), bmiCat.begin(),
+                                     FFM.begin(), FM.begin());
+    }
+    bw_scenario* scenario = bw_scenario_create(days, dt, nsteps, EIchange.begin(), NULL);
+
+    std::vector<NumericMatrix> values;
+    std::vector<bw_buffer>     buffers(variables.size());
+    for (int k = 0; k < variables.size(); k++){
+        values.push_back(NumericMatrix(nind, nsteps));
+        buffers[k].variable = CHAR(STRING_ELT(variables, k));
+        buffers[k].values   = values[k].begin();
+    }
+
+    int ntimes = 0;
+    int status = bw_run(people, scenario, buffers.data(), variables.size(), 1, &ntimes);
+    bw_scenario_free(scenario);
+    bw_population_free(people);
+
+    List results;
+    for (int k = 0; status == BW_OK && k < variables.size(); k++){
+        NumericMatrix written = values[k](_, Range(0, ntimes - 1));
+        results.push_back(written, as<std::string>(variables[k]));
+    }
+
+    return List::create(Named("Status")  = status,
+                        Named("Ntimes")  = ntimes,
+                        Named("Results") = results);
+}
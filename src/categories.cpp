@@ -0,0 +1,127 @@
+//
+//  categories.cpp
+//
+//  This is a function that classifies
+//  the BMI-for-age of the children of the child model
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "categories.h"
+
+//The table has the age (yrs), sex (0 = "male"; 1 = "female"), ht (reference
+//height in m) and the BMI cutoffs of underweight, overweight and obese of each
+//row sorted by sex and age
+Categories::Categories(List table, bool input_prevalence, IntegerVector input_group, int input_ngroups,
+                       NumericVector input_weights){
+    NumericVector age   = table["age"];
+    NumericVector sex   = table["sex"];
+    NumericVector ht    = table["ht"];
+    NumericVector under = table["underweight"];
+    NumericVector over  = table["overweight"];
+    NumericVector obes  = table["obese"];
+    for (int k = 0; k < age.size(); k++){
+        int s = (int) sex(k);
+        ages[s].push_back(age(k));
+        height[s].push_back(ht(k));
+        underweight[s].push_back(under(k));
+        overweight[s].push_back(over(k));
+        obese[s].push_back(obes(k));
+    }
+    prevalence = input_prevalence;
+    ngroups    = input_ngroups;
+    group      = as< std::vector<int> >(input_group);
+    weights    = as< std::vector<double> >(input_weights);
+    row        = std::vector<int>(group.size(), -1);
+    ncolumns   = 0;
+}
+
+Categories::~Categories(void){
+
+}
+
+//Category of the individual of that age, sex and body weight. Ages outside the
+//table take the cutoffs of the closest age.
+int Categories::category(int individual, double age, int sex, double weight){
+
+    const std::vector<double>& a = ages[sex];
+    if (ISNAN(age) || ISNAN(weight) || a.empty()){
+        return NA_INTEGER;
+    }
+
+    //Last row with an age <= age (the row only moves forward)
+    int r = row[individual];
+    while (r + 1 < (int) a.size() && a[r + 1] <= age){
+        r++;
+    }
+    row[individual] = r;
+
+    //Interpolated height and cutoffs
+    int    lo   = std::max(r, 0);
+    int    hi   = std::min(r + 1, (int) a.size() - 1);
+    double frac = (r < 0 || hi == lo) ? 0.0 : (age - a[lo])/(a[hi] - a[lo]);
+    double ht   = height[sex][lo] + frac*(height[sex][hi] - height[sex][lo]);
+    double bmi  = weight/(ht*ht);
+    if (bmi < underweight[sex][lo] + frac*(underweight[sex][hi] - underweight[sex][lo])){
+        return 1;
+    } else if (bmi < overweight[sex][lo] + frac*(overweight[sex][hi] - overweight[sex][lo])){
+        return 2;
+    } else if (bmi < obese[sex][lo] + frac*(obese[sex][hi] - obese[sex][lo])){
+        return 3;
+    }
+    return 4;
+}
+
+//Classify the individuals first, first + 1, ... at a recorded time step (column)
+//and count the weight of each category and group
+void Categories::classify(int column, int first, NumericVector age, NumericVector sex,
+                          NumericVector weight, int* categories){
+
+    if (prevalence && column >= ncolumns){
+        ncolumns = column + 1;
+        counts.resize((size_t) CHILD_CATEGORIES*ngroups*ncolumns, 0.0);
+    }
+
+    size_t size = (size_t) CHILD_CATEGORIES*ngroups;
+    for (int j = 0; j < age.size(); j++){
+        int individual = first + j;
+        int c = category(individual, age(j), (int) sex(j), weight(j));
+        if (categories){
+            categories[j] = c;
+        }
+        if (prevalence && c != NA_INTEGER){
+            counts[(c - 1) + CHILD_CATEGORIES*group[individual] + size*column] += weights[individual];
+        }
+    }
+}
+
+//Weight of each category, group and recorded time step (NULL if the prevalence
+//is not counted)
+SEXP Categories::result(void){
+    if (!prevalence){
+        return R_NilValue;
+    }
+    NumericVector array(counts.begin(), counts.end());
+    array.attr("dim") = IntegerVector::create(CHILD_CATEGORIES, ngroups, ncolumns);
+    return array;
+}
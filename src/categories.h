@@ -0,0 +1,86 @@
+//
+//  categories.h
+//
+//  This is a function that defines
+//  the BMI-for-age categories of the child model in categories.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef categories_h
+#define categories_h
+
+#include <vector>
+#include <algorithm>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//BMI-for-age categories of children (as bmiCat): 1 = Underweight, 2 = Normal,
+//3 = Overweight and 4 = Obese
+const int CHILD_CATEGORIES = 4;
+
+//Create a Categories class that classifies the BMI-for-age of children with a
+//table of the reference height and of the BMI cutoffs of each sex at some ages
+//(linearly interpolated between the ages of the table). As the age of a child
+//only grows, the row of the table of each child is kept and moved forward so a
+//classification takes a few comparisons. The categories are integers and the
+//weighted prevalence of each group is counted at each recorded time step.
+//Blocks of individuals share the prevalence.
+//--------------------------------------------------------------------------------
+class Categories {
+public:
+
+    Categories(List table, bool input_prevalence, IntegerVector input_group, int input_ngroups,
+               NumericVector input_weights);
+    ~Categories(void);
+
+    bool prevalence;  //Whether the prevalence is counted
+
+    //Functions
+    //---------------------------------------------------------------------------
+    int  category(int individual, double age, int sex, double weight);  //NA_INTEGER if unknown
+    void classify(int column, int first, NumericVector age, NumericVector sex, NumericVector weight,
+                  int* categories);  //Categories of individuals first, first + 1, ... (if not NULL)
+    SEXP result(void);  //Category x group x time array of the weight
+
+private:
+
+    int ngroups;
+
+    //Table of each sex (sorted by age)
+    std::vector<double> ages[2];
+    std::vector<double> height[2];
+    std::vector<double> underweight[2];
+    std::vector<double> overweight[2];
+    std::vector<double> obese[2];
+
+    std::vector<int>    row;      //Row of the table of each individual (-1 before the first)
+    std::vector<int>    group;    //Group of each individual (from 0)
+    std::vector<double> weights;
+    std::vector<double> counts;   //Category x group x column
+    int                 ncolumns;
+};
+
+
+#endif /* categories_h */
@@ -71,6 +71,7 @@
 
 
 #include "child_weight.h"
+#include "tiles.h"
 
 //Default (classic) constructor for energy matrix
 Child::Child(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM, NumericMatrix input_EIntake,
@@ -84,6 +85,41 @@ Child::Child(NumericVector input_age, NumericVector input_sex, NumericVector inp
     EIntake = input_EIntake;
     check = checkValues;
     generalized_logistic = false;
+    reference_intake = false;
+    intake_change = false;
+    build();
+}
+
+//Constructor which uses the reference energy intake of a child of the same sex and bmiCat
+Child::Child(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM,
+             double input_dt, bool checkValues){
+    age   = input_age;
+    sex   = input_sex;
+    bmiCat = input_bmiCat;
+    FM    = input_FM;
+    FFM   = input_FFM;
+    dt    = input_dt;
+    check = checkValues;
+    generalized_logistic = false;
+    reference_intake = true;
+    intake_change = false;
+    build();
+}
+
+//Constructor which uses the reference energy intake plus a change in energy intake (each row a time step)
+Child::Child(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM,
+             NumericMatrix input_EIchange, double input_dt, bool checkValues, bool isChange){
+    age   = input_age;
+    sex   = input_sex;
+    bmiCat = input_bmiCat;
+    FM    = input_FM;
+    FFM   = input_FFM;
+    dt    = input_dt;
+    EIntake = input_EIchange;
+    check = checkValues;
+    generalized_logistic = false;
+    reference_intake = true;
+    intake_change = isChange;
     build();
 }
 
@@ -105,6 +141,8 @@ Child::Child(NumericVector input_age, NumericVector input_sex,  NumericVector in
     C_logistic = input_C;
     check = checkValues;
     generalized_logistic = true;
+    reference_intake = false;
+    intake_change = false;
     build();
 }
 
@@ -273,64 +311,178 @@ NumericVector Child::Expenditure(NumericVector t, NumericVector FFM, NumericVect
 }
 
 //Rungue Kutta 4 method for Adult
-List Child::rk4 (double days){
-    
-    //Initial time
-    NumericMatrix k1, k2, k3, k4;
+List Child::rk4(double days, Output output){
     
     //Estimate number of elements to loop into
     int nsims = floor(days/dt);
     
-    //Create array of states
-    NumericMatrix ModelFFM(nind, nsims + 1); //in rcpp
-    NumericMatrix ModelFM(nind, nsims + 1); //in rcpp
-    NumericMatrix ModelBW(nind, nsims + 1); //in rcpp
-    NumericMatrix AGE(nind, nsims + 1); //in rcpp
+    //Create array of states (only for the recorded variables)
+    bool masses = output.records("Fat_Free_Mass") && output.records("Fat_Mass");
+    Trajectory ModelFFM(nind, nsims + 1, output, "Fat_Free_Mass"); //in rcpp
+    Trajectory ModelFM(nind, nsims + 1, output, "Fat_Mass"); //in rcpp
+    Trajectory ModelBW(nind, nsims + 1, output, "Body_Weight", masses); //lazy: FFM + FM
+    Trajectory AGE(nind, nsims + 1, output, "Age", true); //lazy: age + i*dt/365
+    bool recordCAT = output.categories && !output.categories->prevalence;
+    IntegerMatrix CAT(recordCAT ? nind : 0, recordCAT ? output.columns(nsims + 1) : 0); //in rcpp
     NumericVector TIME(nsims + 1); //in rcpp
     
+    //Rolling state (in double precision)
+    NumericVector AGEi = clone(age);
+    NumericVector FFMi = clone(FFM);
+    NumericVector FMi  = clone(FM);
+    
     //Create initial states
-    ModelFFM(_,0) = FFM;
-    ModelFM(_,0)  = FM;
-    ModelBW(_,0)  = FFM + FM;
+    ModelFFM.set(0, FFMi);
+    ModelFM.set(0, FMi);
+    ModelBW.set(0, FFMi + FMi);
     TIME(0)  = 0.0;
-    AGE(_,0)  = age;
+    AGE.set(0, AGEi);
+    if (output.categories){
+        output.categories->classify(0, output.first, AGEi, sex, FFMi + FMi,
+                                    recordCAT ? &CAT(0,0) : NULL);
+    }
     
     //Loop through all other states
     bool correctVals = true;
+    int  completed   = nsims; //Last time step (before if the run is cancelled)
+    NumericMatrix State;
     for (int i = 1; i <= nsims; i++){
 
-        
-        //Rungue kutta 4 (https://en.wikipedia.org/wiki/Runge%E2%80%93Kutta_methods)
-        k1 = dMass(AGE(_,i-1), ModelFFM(_,i-1), ModelFM(_,i-1));
-        k2 = dMass(AGE(_,i-1) + 0.5 * dt/365.0, ModelFFM(_,i-1) + 0.5 * k1(0,_), ModelFM(_,i-1) + 0.5 * k1(1,_));
-        k3 = dMass(AGE(_,i-1) + 0.5 * dt/365.0, ModelFFM(_,i-1) + 0.5 * k2(0,_), ModelFM(_,i-1) + 0.5 * k2(1,_));
-        k4 = dMass(AGE(_,i-1) + dt/365.0, ModelFFM(_,i-1) + k3(0,_), ModelFM(_,i-1) +  k3(1,_));
-        
-        //Update of function values
-        //Note: The dt is factored from the k1, k2, k3, k4 defined on the Wikipedia page and that is why
-        //      it appears here.
-        ModelFFM(_,i) = ModelFFM(_,i-1) + dt*(k1(0,_) + 2.0*k2(0,_) + 2.0*k3(0,_) + k4(0,_))/6.0;        //ffm
-        ModelFM(_,i)  = ModelFM(_,i-1)  + dt*(k1(1,_) + 2.0*k2(1,_) + 2.0*k3(1,_) + k4(1,_))/6.0;        //fm
+        //Rungue kutta 4 step from previous state
+        State = rk4_step(AGEi, FFMi, FMi);
+        FFMi  = State(0,_);        //ffm
+        FMi   = State(1,_);        //fm
+        ModelFFM.set(i, FFMi);
+        ModelFM.set(i, FMi);
         
         //Update weight
-        ModelBW(_,i) = ModelFFM(_,i) + ModelFM(_,i);
+        ModelBW.set(i, FFMi + FMi);
         
         //Update TIME(i-1)
         TIME(i) = TIME(i-1) + dt; // Currently time counts the time (days) passed since start of model
         
         //Update AGE variable
-        AGE(_,i) = AGE(_,i-1) + dt/365.0; //Age is variable in years
+        AGEi = AGEi + dt/365.0; //Age is variable in years
+        AGE.set(i, AGEi);
+        
+        //Classify BMI-for-age
+        if (output.categories && output.column(i) >= 0){
+            output.categories->classify(output.column(i), output.first, AGEi, sex, FFMi + FMi,
+                                        recordCAT ? &CAT(0,output.column(i)) : NULL);
+        }
+        
+        //Report progress; a cancelled run returns the time steps done so far
+        if (!output.proceed(i, nsims, nind)){
+            completed = i;
+            break;
+        }
+    }
+    
+    //Derived results are computed when read
+    PROFILE_SCOPE("results");
+    RObject ResultAGE = AGE.lazy() ?
+        lazy_age(clone(age), output.every*dt/365.0, output.columns(nsims + 1)) : AGE.result();
+    RObject ResultBW  = ModelBW.lazy() ?
+        lazy_sum(NumericMatrix(ModelFFM.result()), NumericMatrix(ModelFM.result())) : ModelBW.result();
+    
+    return recorded(List::create(Named("Time") = output.times(TIME),
+                                 Named("Age") = ResultAGE,
+                                 Named("Fat_Free_Mass") = ModelFFM.result(),
+                                 Named("Fat_Mass") = ModelFM.result(),
+                                 Named("Body_Weight") = ResultBW,
+                                 Named("BMI_Category") = recordCAT ? (SEXP) CAT : R_NilValue,
+                                 Named("BMI_Prevalence") = output.categories ?
+                                     output.categories->result() : R_NilValue,
+                                 Named("Correct_Values")=correctVals,
+                                 Named("Model_Type")="Children",
+                                 Named("Interrupted") = completed < nsims ?
+                                     (SEXP) interrupted(nind, output.columns(completed + 1)) : R_NilValue));
+
+
+}
+
+//Rungue Kutta 4 method by blocks of blocksize individuals. Each block is run
+//through all the days before the next one starts.
+List Child::rk4_tiled(double days, int blocksize, Output output){
+    
+    output.population = nind;
+    if (blocksize <= 0 || blocksize >= nind){
+        List Model = rk4(days, output);
+        output.close();
+        return Model;
     }
     
-    return List::create(Named("Time") = TIME,
-                        Named("Age") = AGE,
-                        Named("Fat_Free_Mass") = ModelFFM,
-                        Named("Fat_Mass") = ModelFM,
-                        Named("Body_Weight") = ModelBW,
-                        Named("Correct_Values")=correctVals,
-                        Named("Model_Type")="Children");
+    List Model;
+    for (int start = 0; start < nind; start += blocksize){
+        int end    = std::min(start + blocksize, nind);
+        Output blockoutput = output;
+        blockoutput.first  = output.first + start;
+        List Block = block(start, end).rk4(days, blockoutput);
+        if (Block.containsElementNamed("Interrupted")){
+            Model = start == 0 ? Block : interrupted_tiles(Model, start, nind);
+            break;
+        }
+        if (start == 0){
+            Model = allocate_tiles(Block, nind);
+        }
+        copy_tile(Model, Block, start);
+    }
+    output.close();
+    
+    return Model;
+}
 
+//Children in positions start to end - 1 with the same energy intake
+Child Child::block(int start, int end){
+    return select(seq(start, end - 1));
+}
+
+//Children in the given positions (from 0)
+Child Child::select(IntegerVector rows){
+    
+    NumericVector block_age    = age[rows];
+    NumericVector block_sex    = sex[rows];
+    NumericVector block_bmiCat = bmiCat[rows];
+    NumericVector block_FFM    = FFM[rows];
+    NumericVector block_FM     = FM[rows];
+    
+    if (generalized_logistic){
+        return Child(block_age, block_sex, block_bmiCat, block_FFM, block_FM, K_logistic, Q_logistic,
+                     A_logistic, B_logistic, nu_logistic, C_logistic, dt, check);
+    } else if (reference_intake && intake_change){
+        return Child(block_age, block_sex, block_bmiCat, block_FFM, block_FM,
+                     column_select(EIntake, rows), dt, check, true);
+    } else if (reference_intake){
+        return Child(block_age, block_sex, block_bmiCat, block_FFM, block_FM, dt, check);
+    } else {
+        return Child(block_age, block_sex, block_bmiCat, block_FFM, block_FM,
+                     column_select(EIntake, rows), dt, check);
+    }
+}
 
+//Single Rungue Kutta 4 step starting at age t with masses FFM and FM.
+//Returns a matrix whose first row is the new FFM and second row the new FM.
+NumericMatrix Child::rk4_step(NumericVector t, NumericVector FFM, NumericVector FM){
+    
+    PROFILE_SCOPE("rk4_step");
+    PROFILE_COUNT("rhs_evaluations", 4.0*nind); //k1 to k4 of each individual
+    
+    NumericMatrix k1, k2, k3, k4;
+    NumericMatrix State(2, nind);
+    
+    //Rungue kutta 4 (https://en.wikipedia.org/wiki/Runge%E2%80%93Kutta_methods)
+    k1 = dMass(t, FFM, FM);
+    k2 = dMass(t + 0.5 * dt/365.0, FFM + 0.5 * k1(0,_), FM + 0.5 * k1(1,_));
+    k3 = dMass(t + 0.5 * dt/365.0, FFM + 0.5 * k2(0,_), FM + 0.5 * k2(1,_));
+    k4 = dMass(t + dt/365.0, FFM + k3(0,_), FM +  k3(1,_));
+    
+    //Update of function values
+    //Note: The dt is factored from the k1, k2, k3, k4 defined on the Wikipedia page and that is why
+    //      it appears here.
+    State(0,_) = FFM + dt*(k1(0,_) + 2.0*k2(0,_) + 2.0*k3(0,_) + k4(0,_))/6.0;        //ffm
+    State(1,_) = FM  + dt*(k1(1,_) + 2.0*k2(1,_) + 2.0*k3(1,_) + k4(1,_))/6.0;        //fm
+    
+    return State;
 }
 
 NumericMatrix  Child::dMass (NumericVector t, NumericVector FFM, NumericVector FM){
@@ -348,6 +500,8 @@ NumericMatrix  Child::dMass (NumericVector t, NumericVector FFM, NumericVector F
 
 void Child::getParameters(void){
     
+    PROFILE_SCOPE("getParameters");
+    
     //General constants
     rhoFM    = 9.4*1000.0;
     deltamin = 10.0;
@@ -396,8 +550,14 @@ void Child::getParameters(void){
 
 //Intake in calories
 NumericVector Child::Intake(NumericVector t){
+    PROFILE_SCOPE("intake");
     if (generalized_logistic) {
         return A_logistic + (K_logistic - A_logistic)/pow(C_logistic + Q_logistic*exp(-B_logistic*t), 1/nu_logistic); //t in years
+    } else if (reference_intake && intake_change) {
+        int timeval = floor(365.0*(t(0) - age(0))/dt);
+        return IntakeReference(t) + EIntake(timeval,_);
+    } else if (reference_intake) {
+        return IntakeReference(t);
     } else {
         int timeval = floor(365.0*(t(0) - age(0))/dt); //Example: Age: 6 and t: 7.1 => timeval = 401 which corresponds to the 401 entry of matrix
         return EIntake(timeval,_);
@@ -32,6 +32,9 @@
 
 #include <math.h>
 #include <Rcpp.h>
+#include "trajectory.h"
+#include "lazy.h"
+#include "profile.h"
 using namespace Rcpp;
 
 //Create a Adult class to contain individual parameters
@@ -43,6 +46,9 @@ public:
     Child(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM, NumericMatrix input_EIntake, double input_dt, bool checkValues);
     Child(NumericVector input_age, NumericVector input_sex,  NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM,  double input_K, double input_Q, double input_A, double input_B, double input_nu, double input_C,
           double input_dt, bool checkValues);
+    Child(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM, double input_dt, bool checkValues);
+    Child(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat, NumericVector input_FFM, NumericVector input_FM, NumericMatrix input_EIchange,
+          double input_dt, bool checkValues, bool isChange);
     
     ~Child(void);
     
@@ -57,7 +63,11 @@ public:
     
     //Functions
     //---------------------------------------------------------------------------
-    List rk4(double days);
+    List rk4(double days, Output output = Output());
+    List rk4_tiled(double days, int blocksize, Output output = Output());
+    NumericMatrix rk4_step(NumericVector t, NumericVector FFM, NumericVector FM);
+    Child block(int start, int end);
+    Child select(IntegerVector rows);
     
     //Reference functions for reference children
     NumericVector IntakeReference(NumericVector t);
@@ -73,6 +83,8 @@ private:
     double h;
     double dt;
     bool generalized_logistic;
+    bool reference_intake;
+    bool intake_change;
     
     //Number of individuals
     int nind;
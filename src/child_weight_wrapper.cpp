@@ -76,24 +76,28 @@
 #include "child_weight.h"
 
 // [[Rcpp::export]]
-List child_weight_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericMatrix input_EIntake, double days, double dt, bool checkValues){
+List child_weight_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, NumericMatrix input_EIntake, double days, double dt, bool checkValues, int blocksize, List output){
+    
+    profile_reset();
     
     //Create new adult with characteristics
     Child Person (age,  sex, bmiCat, FFM, FM, input_EIntake, dt, checkValues);
     
     //Run model using RK4
-    return Person.rk4(days - 1); //days - 1 to account for extra day (c++ indexing starts in 0; R in 1)
+    return profile_result(Person.rk4_tiled(days - 1, blocksize, Output(output))); //days - 1 to account for extra day (c++ indexing starts in 0; R in 1)
     
 }
 
 // [[Rcpp::export]]
-List child_weight_wrapper_richardson(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, double K, double Q, double A, double B, double nu, double C, double days, double dt, bool checkValues){
+List child_weight_wrapper_richardson(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM, NumericVector FM, double K, double Q, double A, double B, double nu, double C, double days, double dt, bool checkValues, int blocksize, List output){
+    
+    profile_reset();
     
     //Create new adult with characteristics
     Child Person (age,  sex, bmiCat, FFM, FM, K, Q, A, B, nu, C, dt, checkValues);
     
     //Run model using RK4
-    return Person.rk4(days - 1); //days - 1 to account for extra day (c++ indexing starts in 0; R in 1)
+    return profile_result(Person.rk4_tiled(days - 1, blocksize, Output(output))); //days - 1 to account for extra day (c++ indexing starts in 0; R in 1)
     
 }
 
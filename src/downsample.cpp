@@ -0,0 +1,161 @@
+//
+//  downsample.cpp
+//
+//  This is a function that reduces the points of the trajectories of a
+//  model before they are plotted: Largest-Triangle-Three-Buckets keeps the
+//  shape of each trajectory with fewer points and the envelope summarises
+//  all the individuals of each time step with their range and quantiles.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//Positions of the points of a trajectory (y at times x) chosen by
+//Largest-Triangle-Three-Buckets (Steinarsson, 2013): the first and last points
+//and, in each of points - 2 buckets, the point that makes the largest triangle
+//with the previous chosen point and the mean of the next bucket.
+static std::vector<int> lttb(const double* x, const double* y, int n, int points){
+
+    std::vector<int> chosen;
+    if (points >= n || points < 3){
+        for (int i = 0; i < n; i++){
+            chosen.push_back(i);
+        }
+        return chosen;
+    }
+
+    double bucket = (double) (n - 2)/(points - 2);
+    int    a      = 0;
+    chosen.push_back(0);
+    for (int b = 0; b < points - 2; b++){
+
+        //Mean of the next bucket (the last point for the last bucket)
+        int    nextstart = (int) floor((b + 1)*bucket) + 1;
+        int    nextend   = std::min((int) floor((b + 2)*bucket) + 1, n);
+        double meanx     = 0;
+        double meany     = 0;
+        for (int i = nextstart; i < nextend; i++){
+            meanx += x[i];
+            meany += y[i];
+        }
+        meanx /= (nextend - nextstart);
+        meany /= (nextend - nextstart);
+
+        //Largest triangle in the current bucket
+        int    start = (int) floor(b*bucket) + 1;
+        int    end   = (int) floor((b + 1)*bucket) + 1;
+        double best  = -1;
+        int    next  = start;
+        for (int i = start; i < end; i++){
+            double area = fabs((x[a] - meanx)*(y[i] - y[a]) - (x[a] - x[i])*(meany - y[a]));
+            if (area > best){
+                best = area;
+                next = i;
+            }
+        }
+        chosen.push_back(next);
+        a = next;
+    }
+    chosen.push_back(n - 1);
+
+    return chosen;
+}
+
+//Downsampled trajectory of each individual (rows of x) in long format
+// [[Rcpp::export]]
+List lttb_wrapper(NumericMatrix x, NumericVector time, int points){
+
+    int nind   = x.nrow();
+    int ntimes = x.ncol();
+    int kept   = std::min(points, ntimes);
+
+    std::vector<int>    individual;
+    std::vector<double> times;
+    std::vector<double> values;
+    individual.reserve((size_t) nind*kept);
+    times.reserve((size_t) nind*kept);
+    values.reserve((size_t) nind*kept);
+
+    std::vector<double> y(ntimes);
+    for (int i = 0; i < nind; i++){
+        for (int t = 0; t < ntimes; t++){
+            y[t] = x(i, t);
+        }
+        std::vector<int> chosen = lttb(time.begin(), y.data(), ntimes, points);
+        for (size_t k = 0; k < chosen.size(); k++){
+            individual.push_back(i + 1);
+            times.push_back(time(chosen[k]));
+            values.push_back(y[chosen[k]]);
+        }
+    }
+
+    return List::create(Named("Individual") = wrap(individual),
+                        Named("Time")       = wrap(times),
+                        Named("Value")      = wrap(values));
+}
+
+//Minimum, maximum and quantiles (as quantile's default type 7) of all the
+//individuals at each time step (columns of x); missing values are skipped
+// [[Rcpp::export]]
+NumericMatrix envelope_wrapper(NumericMatrix x, NumericVector probs){
+
+    int nind   = x.nrow();
+    int ntimes = x.ncol();
+    int nprobs = probs.size();
+
+    NumericMatrix envelope(ntimes, nprobs + 2);
+    std::vector<double> values;
+    values.reserve(nind);
+    for (int t = 0; t < ntimes; t++){
+        values.clear();
+        for (int i = 0; i < nind; i++){
+            if (!ISNAN(x(i, t))){
+                values.push_back(x(i, t));
+            }
+        }
+        int n = values.size();
+        if (n == 0){
+            for (int k = 0; k < nprobs + 2; k++){
+                envelope(t, k) = NA_REAL;
+            }
+            continue;
+        }
+        std::sort(values.begin(), values.end());
+        envelope(t, 0) = values[0];
+        envelope(t, 1) = values[n - 1];
+        for (int k = 0; k < nprobs; k++){
+            double h  = (n - 1)*probs(k);
+            int    lo = (int) floor(h);
+            int    hi = std::min(lo + 1, n - 1);
+            envelope(t, k + 2) = values[lo] + (h - lo)*(values[hi] - values[lo]);
+        }
+    }
+
+    return envelope;
+}
@@ -0,0 +1,130 @@
+//
+//  groups.cpp
+//
+//  This is a function that builds the index of the groups of a population
+//  given by several grouping columns (e.g. state, sex and age band) with a
+//  hash table. The moments of each group are taken by moments_wrapper in
+//  shard.cpp and combined into margins in model_aggregate.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//64 bit FNV-1a hash of the codes of a row
+static uint64_t hash_codes(const std::vector<const int*>& columns, int row){
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t k = 0; k < columns.size(); k++){
+        uint32_t code = (uint32_t) columns[k][row];
+        for (int b = 0; b < 4; b++){
+            hash ^= (uint64_t) ((code >> (8*b)) & 0xFF);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+//Group (from 1) of each row of the integer codes of the grouping columns. The
+//distinct rows are found with an open addressing hash table (one pass) and the
+//groups are numbered in the lexicographic order of their codes so that the
+//result does not depend on the order of the rows. Returns the Group of each
+//row and the Keys (codes) of each group.
+// [[Rcpp::export]]
+List group_wrapper(List codes){
+
+    int ncols = codes.size();
+    int nrows = ncols > 0 ? Rf_length(codes[0]) : 0;
+    std::vector<const int*> columns(ncols);
+    for (int k = 0; k < ncols; k++){
+        columns[k] = INTEGER(codes[k]);
+    }
+
+    //Hash table of the first row of each distinct group (a power of 2 with
+    //at least twice the rows so that probes are short)
+    size_t size = 16;
+    while (size < 2*(size_t) nrows){
+        size *= 2;
+    }
+    std::vector<int> table(size, -1);
+    std::vector<int> first;
+    std::vector<int> found(nrows);
+    for (int i = 0; i < nrows; i++){
+        size_t slot = hash_codes(columns, i) & (size - 1);
+        while (true){
+            int j = table[slot];
+            if (j < 0){
+                table[slot] = first.size();
+                found[i]    = first.size();
+                first.push_back(i);
+                break;
+            }
+            bool same = true;
+            for (int k = 0; k < ncols && same; k++){
+                same = columns[k][first[j]] == columns[k][i];
+            }
+            if (same){
+                found[i] = j;
+                break;
+            }
+            slot = (slot + 1) & (size - 1);
+        }
+    }
+
+    //Number the groups in the order of their codes
+    int ngroups = first.size();
+    std::vector<int> order(ngroups);
+    for (int g = 0; g < ngroups; g++){
+        order[g] = g;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b){
+        for (int k = 0; k < ncols; k++){
+            int x = columns[k][first[a]];
+            int y = columns[k][first[b]];
+            if (x != y){
+                return x < y;
+            }
+        }
+        return false;
+    });
+    std::vector<int> rank(ngroups);
+    IntegerMatrix Keys(ngroups, ncols);
+    for (int g = 0; g < ngroups; g++){
+        rank[order[g]] = g;
+        for (int k = 0; k < ncols; k++){
+            Keys(g, k) = columns[k][first[order[g]]];
+        }
+    }
+
+    IntegerVector Group(nrows);
+    for (int i = 0; i < nrows; i++){
+        Group(i) = rank[found[i]] + 1;
+    }
+
+    return List::create(Named("Group") = Group,
+                        Named("Keys")  = Keys);
+}
@@ -0,0 +1,110 @@
+//
+//  layout.cpp
+//
+//  This is a function that changes the layout of the results of the
+//  models and reads single trajectories or days from them.
+//  The models return matrices with a row for each individual and a
+//  column for each time step ("individual" layout) where each day is
+//  contiguous in memory. In the "time" layout the matrices are transposed
+//  so that the trajectory of each individual is contiguous. The models also
+//  get it this way, as a transpose of their results once the run ends (so
+//  the matrices are briefly in memory twice).
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <Rcpp.h>
+#include <algorithm>
+using namespace Rcpp;
+
+//Transpose by square blocks so that both the reads and the writes of a block stay in cache
+template <int RTYPE>
+static Matrix<RTYPE> block_transpose(Matrix<RTYPE> x){
+    const int block = 64;
+    int nrow = x.nrow();
+    int ncol = x.ncol();
+    Matrix<RTYPE> tx(ncol, nrow);
+    for (int jb = 0; jb < ncol; jb += block){
+        for (int ib = 0; ib < nrow; ib += block){
+            int jmax = std::min(jb + block, ncol);
+            int imax = std::min(ib + block, nrow);
+            for (int j = jb; j < jmax; j++){
+                for (int i = ib; i < imax; i++){
+                    tx(j, i) = x(i, j);
+                }
+            }
+        }
+    }
+    return tx;
+}
+
+// [[Rcpp::export]]
+List layout_wrapper(List model, std::string layout){
+
+    //Current layout of the model
+    std::string current = "individual";
+    if (model.hasAttribute("layout")){
+        current = as<std::string>(model.attr("layout"));
+    }
+
+    //Only the matrices are copied (transposed); other elements are shared
+    List result(model.size());
+    for (int k = 0; k < model.size(); k++){
+        SEXP element = model[k];
+        if (current != layout && Rf_isMatrix(element) && TYPEOF(element) == REALSXP){
+            result[k] = block_transpose<REALSXP>(NumericMatrix(element));
+        } else if (current != layout && Rf_isMatrix(element) && TYPEOF(element) == STRSXP){
+            result[k] = block_transpose<STRSXP>(StringMatrix(element));
+        } else if (current != layout && Rf_isMatrix(element) && TYPEOF(element) == INTSXP){
+            IntegerMatrix transposed = block_transpose<INTSXP>(IntegerMatrix(element));
+            transposed.attr("class") = Rf_getAttrib(element, R_ClassSymbol); //e.g. float_matrix
+            result[k] = transposed;
+        } else {
+            result[k] = element;
+        }
+    }
+    result.attr("names")  = model.attr("names");
+    result.attr("layout") = layout;
+    if (model.hasAttribute("Profile")){
+        result.attr("Profile") = model.attr("Profile");
+    }
+
+    return result;
+}
+
+//Contiguous column of a matrix
+// [[Rcpp::export]]
+NumericVector column_wrapper(NumericMatrix x, int j){
+    NumericMatrix::Column column = x(_, j);
+    return NumericVector(column.begin(), column.end());
+}
+
+//Row of a matrix (read with stride nrow)
+// [[Rcpp::export]]
+NumericVector row_wrapper(NumericMatrix x, int i){
+    NumericVector row(x.ncol());
+    for (int j = 0; j < x.ncol(); j++){
+        row(j) = x(i, j);
+    }
+    return row;
+}
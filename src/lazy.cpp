@@ -0,0 +1,193 @@
+//
+//  lazy.cpp
+//
+//  This is a function that returns results of the models that are
+//  functions of other results (age, body weight of children and BMI of
+//  adults) as ALTREP matrices whose elements are computed when read.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include "lazy.h"
+
+#if R_VERSION >= R_Version(3, 5, 0)
+#define LAZY_ALTREP
+#if R_VERSION < R_Version(3, 6, 0)
+//R 3.5 headers use class as a variable name
+#define class klass
+extern "C" {
+#include <R_ext/Altrep.h>
+}
+#undef class
+#else
+#include <R_ext/Altrep.h>
+#endif
+#endif
+
+//Functions that define each element
+enum Lazy {
+    LAZY_AGE   = 0,  //first[i % n] + (i / n)*step with n = length(first)
+    LAZY_SUM   = 1,  //first[i] + second[i]
+    LAZY_RATIO = 2   //first[i] / second[i % n] with n = length(second)
+};
+
+//Elements start to start + n - 1 of a lazy matrix given by its definition
+static void lazy_values(int kind, SEXP first, SEXP second, double step,
+                        R_xlen_t start, R_xlen_t n, double* values){
+    const double* x = REAL(first);
+    if (kind == LAZY_AGE){
+        R_xlen_t nind = XLENGTH(first);
+        for (R_xlen_t i = start; i < start + n; i++){
+            values[i - start] = x[i % nind] + (i / nind)*step;
+        }
+    } else if (kind == LAZY_SUM){
+        const double* y = REAL(second);
+        for (R_xlen_t i = start; i < start + n; i++){
+            values[i - start] = x[i] + y[i];
+        }
+    } else {
+        const double* y   = REAL(second);
+        R_xlen_t      nind = XLENGTH(second);
+        for (R_xlen_t i = start; i < start + n; i++){
+            values[i - start] = x[i] / y[i % nind];
+        }
+    }
+}
+
+#ifdef LAZY_ALTREP
+
+//The definition (data1) is a list with the kind, the vectors it uses, the step
+//and the length. The matrix (data2) is NULL until it is allocated.
+static R_altrep_class_t lazy_class;
+
+static R_xlen_t lazy_length(SEXP x){
+    return (R_xlen_t) REAL(VECTOR_ELT(R_altrep_data1(x), 4))[0];
+}
+
+static void lazy_region(SEXP x, R_xlen_t start, R_xlen_t n, double* values){
+    SEXP definition = R_altrep_data1(x);
+    lazy_values(INTEGER(VECTOR_ELT(definition, 0))[0], VECTOR_ELT(definition, 1),
+                VECTOR_ELT(definition, 2), REAL(VECTOR_ELT(definition, 3))[0],
+                start, n, values);
+}
+
+//Allocate the matrix when R needs its memory
+static void* lazy_dataptr(SEXP x, Rboolean writeable){
+    SEXP values = R_altrep_data2(x);
+    if (values == R_NilValue){
+        R_xlen_t n = lazy_length(x);
+        values = PROTECT(Rf_allocVector(REALSXP, n));
+        lazy_region(x, 0, n, REAL(values));
+        R_set_altrep_data2(x, values);
+        UNPROTECT(1);
+    }
+    return REAL(values);
+}
+
+static const void* lazy_dataptr_or_null(SEXP x){
+    SEXP values = R_altrep_data2(x);
+    if (values == R_NilValue){
+        return NULL;
+    }
+    return REAL(values);
+}
+
+static double lazy_elt(SEXP x, R_xlen_t i){
+    SEXP values = R_altrep_data2(x);
+    if (values != R_NilValue){
+        return REAL(values)[i];
+    }
+    double value;
+    lazy_region(x, i, 1, &value);
+    return value;
+}
+
+static R_xlen_t lazy_get_region(SEXP x, R_xlen_t start, R_xlen_t size, double* buffer){
+    R_xlen_t n = std::min(size, lazy_length(x) - start);
+    SEXP values = R_altrep_data2(x);
+    if (values != R_NilValue){
+        std::copy(REAL(values) + start, REAL(values) + start + n, buffer);
+    } else {
+        lazy_region(x, start, n, buffer);
+    }
+    return n;
+}
+
+static Rboolean lazy_inspect(SEXP x, int pre, int deep, int pvec,
+                             void (*inspect_subtree)(SEXP, int, int, int)){
+    Rprintf("lazy matrix (%s)\n", R_altrep_data2(x) == R_NilValue ? "not allocated" : "allocated");
+    return TRUE;
+}
+
+#endif
+
+// [[Rcpp::init]]
+void lazy_init(DllInfo* dll){
+#ifdef LAZY_ALTREP
+    lazy_class = R_make_altreal_class("lazy_matrix", "bw", dll);
+    R_set_altrep_Length_method(lazy_class, lazy_length);
+    R_set_altrep_Inspect_method(lazy_class, lazy_inspect);
+    R_set_altvec_Dataptr_method(lazy_class, lazy_dataptr);
+    R_set_altvec_Dataptr_or_null_method(lazy_class, lazy_dataptr_or_null);
+    R_set_altreal_Elt_method(lazy_class, lazy_elt);
+    R_set_altreal_Get_region_method(lazy_class, lazy_get_region);
+#endif
+}
+
+//Lazy matrix of nrow x ncol
+static SEXP lazy_matrix(int kind, SEXP first, SEXP second, double step, int nrow, int ncol){
+
+    R_xlen_t n = (R_xlen_t) nrow*ncol;
+
+#ifdef LAZY_ALTREP
+    List definition = List::create(IntegerVector::create(kind), first, second,
+                                   NumericVector::create(step), NumericVector::create((double) n));
+    SEXP x = PROTECT(R_new_altrep(lazy_class, definition, R_NilValue));
+#else
+    SEXP x = PROTECT(Rf_allocVector(REALSXP, n));
+    lazy_values(kind, first, second, step, 0, n, REAL(x));
+#endif
+
+    IntegerVector dim = IntegerVector::create(nrow, ncol);
+    Rf_setAttrib(x, R_DimSymbol, dim);
+    UNPROTECT(1);
+    return x;
+}
+
+//Age of each individual at each time step: age + i*step
+SEXP lazy_age(NumericVector age, double step, int ntimes){
+    return lazy_matrix(LAZY_AGE, age, R_NilValue, step, age.size(), ntimes);
+}
+
+//Sum of two matrices of the same size
+SEXP lazy_sum(NumericMatrix x, NumericMatrix y){
+    return lazy_matrix(LAZY_SUM, x, y, 0.0, x.nrow(), x.ncol());
+}
+
+//Each row of a matrix divided by a value
+SEXP lazy_ratio(NumericMatrix x, NumericVector divisor){
+    return lazy_matrix(LAZY_RATIO, x, divisor, 0.0, x.nrow(), x.ncol());
+}
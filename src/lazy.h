@@ -0,0 +1,52 @@
+//
+//  lazy.h
+//
+//  This is a function that defines
+//  all the variables needed in lazy.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+
+
+#ifndef lazy_h
+#define lazy_h
+
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//Results of the models that are functions of other results. Each element is
+//computed when it is read and the whole matrix is only allocated if R asks for
+//its memory (e.g. to modify it). Without ALTREP (R < 3.5) the matrices are
+//computed right away.
+
+//Age of each individual at each time step: age + i*step
+SEXP lazy_age(NumericVector age, double step, int ntimes);
+
+//Sum of two matrices of the same size (e.g. fat free mass + fat mass)
+SEXP lazy_sum(NumericMatrix x, NumericMatrix y);
+
+//Each row of a matrix divided by a value (e.g. body weight / height^2)
+SEXP lazy_ratio(NumericMatrix x, NumericVector divisor);
+
+#endif /* lazy_h */
@@ -0,0 +1,205 @@
+//
+//  life_course.cpp
+//
+//  This is a function that calculates weight change from childhood into
+//  adulthood. Each individual is modelled with the children model by
+//  Kevin D. Hall et al. until the individual turns 18; at that moment
+//  the fat and fat free mass of the individual become the baseline of
+//  the adult model which is used for the remaining time. Both models
+//  are solved with Runge Kutta 4 in the same loop, each one only for the
+//  individuals that are in it.
+//
+//  Input:
+//  age             .-  Years since individual first arrived to Earth
+//  sex             .-  Either 1 = "female" or 0 = "male"
+//  bmiCat          .-  BMI category of the child (1 to 4)
+//  FFM             .-  Fat Free Mass (kg) of the individual
+//  FM              .-  Fat Mass (kg) of the individual
+//  ht              .-  Height (m) of the individual as an adult
+//  input_EIntake   .-  Energy intake (kcal) of individual per day while a child
+//  EIchange        .-  Change in energy intake (kcal) from adult baseline.
+//  NAchange        .-  Change in sodium consumption (mg) from adult baseline.
+//  PAL             .-  Physical activity level as an adult.
+//  pcarb           .-  Proportion of carbohydrates from diet as an adult.
+//  pcarb_base      .-  Proportion of carbohydrates from diet at adult baseline.
+//  dt              .-  Time step used to solve the ODE system numerically
+//  Note:
+//  Every matrix is indexed by the time step since the start of the model
+//  (rows) and individual (columns). Please see child_weight.cpp and
+//  adult_weight.cpp for additional information on each model.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "life_course.h"
+#include "population.h" //which_true
+
+//Constructor with energy intake matrix for the child phase
+LifeCourse::LifeCourse(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+                       NumericVector input_FFM, NumericVector input_FM, NumericVector input_ht,
+                       NumericMatrix input_EIntake, NumericMatrix input_EIchange,
+                       NumericMatrix input_NAchange, NumericVector input_PAL,
+                       NumericVector input_pcarb_base, NumericVector input_pcarb,
+                       double input_dt, bool checkValues) :
+    child(input_age, input_sex, input_bmiCat, input_FFM, input_FM, input_EIntake, input_dt, checkValues),
+    adult(input_FFM + input_FM, input_ht, input_age, input_sex, input_EIchange, input_NAchange,
+          input_PAL, input_pcarb, input_pcarb_base, input_dt, input_FM, checkValues, false){
+    age       = input_age;
+    FFM       = input_FFM;
+    FM        = input_FM;
+    dt        = input_dt;
+    check     = checkValues;
+    adult_age = 18.0;
+    nind      = age.size();
+}
+
+//Constructor with reference energy intake for the child phase
+LifeCourse::LifeCourse(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+                       NumericVector input_FFM, NumericVector input_FM, NumericVector input_ht,
+                       NumericMatrix input_EIchange, NumericMatrix input_NAchange,
+                       NumericVector input_PAL, NumericVector input_pcarb_base,
+                       NumericVector input_pcarb, double input_dt, bool checkValues) :
+    child(input_age, input_sex, input_bmiCat, input_FFM, input_FM, input_dt, checkValues),
+    adult(input_FFM + input_FM, input_ht, input_age, input_sex, input_EIchange, input_NAchange,
+          input_PAL, input_pcarb, input_pcarb_base, input_dt, input_FM, checkValues, false){
+    age       = input_age;
+    FFM       = input_FFM;
+    FM        = input_FM;
+    dt        = input_dt;
+    check     = checkValues;
+    adult_age = 18.0;
+    nind      = age.size();
+}
+
+LifeCourse::~LifeCourse(void){
+
+}
+
+//Rungue Kutta 4 method for LifeCourse
+List LifeCourse::rk4(double days){
+
+    //Estimate number of elements to loop into
+    int nsims = floor(days/dt);
+
+    //Create array of states
+    NumericMatrix ModelFFM(nind, nsims + 1); //in rcpp
+    NumericMatrix ModelFM(nind, nsims + 1); //in rcpp
+    NumericMatrix ModelBW(nind, nsims + 1); //in rcpp
+    NumericMatrix AGE(nind, nsims + 1); //in rcpp
+    NumericVector TIME(nsims + 1); //in rcpp
+
+    //Create initial states
+    ModelFFM(_,0) = FFM;
+    ModelFM(_,0)  = FM;
+    ModelBW(_,0)  = FFM + FM;
+    TIME(0)  = 0.0;
+    AGE(_,0)  = age;
+
+    //Individuals that are already adults start in the adult model. Each model
+    //is only solved for its own individuals (children and adults are kept as
+    //positions in the whole population).
+    LogicalVector isAdult = age >= adult_age;
+    NumericMatrix AdultState = adult.rebase(isAdult, FFM + FM, age, FM);
+    IntegerVector childrows, adultrows;
+    Child         childstep = child;
+    Adult         adultstep = adult;
+    bool          handoff   = true;
+
+    //Loop through all other states
+    bool correctVals = true;
+    NumericMatrix ChildState, SubState, Baseline;
+    NumericVector F, BW;
+    for (int i = 1; i <= nsims; i++){
+
+        //Models of the children and the adults after a hand off
+        if (handoff){
+            childrows = which_true(!isAdult);
+            adultrows = which_true(isAdult);
+            childstep = childrows.size() > 0 ? child.select(childrows) : child;
+            adultstep = adultrows.size() > 0 ? adult.select(adultrows) : adult;
+            SubState  = NumericMatrix(4, adultrows.size());
+            handoff   = false;
+        }
+
+        //Children
+        if (childrows.size() > 0){
+            NumericVector ages = AGE(_,i-1);
+            NumericVector ffm  = ModelFFM(_,i-1);
+            NumericVector fm   = ModelFM(_,i-1);
+            ChildState = childstep.rk4_step(ages[childrows], ffm[childrows], fm[childrows]);
+            for (int k = 0; k < childrows.size(); k++){
+                ModelFFM(childrows(k),i) = ChildState(0,k);
+                ModelFM(childrows(k),i)  = ChildState(1,k);
+            }
+        }
+
+        //Adults
+        if (adultrows.size() > 0){
+            for (int k = 0; k < adultrows.size(); k++){
+                SubState(_,k) = AdultState(_,adultrows(k));
+            }
+            SubState = adultstep.rk4_step(TIME(i-1), SubState);
+            F  = adultstep.fatMass(SubState(3,_));
+            BW = F + SubState(3,_) + SubState(1,_) + 3.7*SubState(2,_);
+            for (int k = 0; k < adultrows.size(); k++){
+                AdultState(_,adultrows(k)) = SubState(_,k);
+                ModelFM(adultrows(k),i)  = F(k);
+                ModelFFM(adultrows(k),i) = BW(k) - F(k);
+            }
+        }
+
+        //Update weight
+        ModelBW(_,i) = ModelFFM(_,i) + ModelFM(_,i);
+
+        //Update TIME(i-1)
+        TIME(i) = TIME(i-1) + dt; // Currently time counts the time (days) passed since start of model
+
+        //Update AGE variable
+        AGE(_,i) = AGE(_,i-1) + dt/365.0; //Age is variable in years
+
+        //Hand the children that turned 18 to the adult model
+        LogicalVector turning = !isAdult & (AGE(_,i) >= adult_age);
+        if (is_true(any(turning))){
+            Baseline = adult.rebase(turning, ModelBW(_,i), AGE(_,i), ModelFM(_,i));
+            for (int j = 0; j < 4; j++){
+                AdultState(j,_) = ifelse(turning, Baseline(j,_), AdultState(j,_));
+            }
+            isAdult = isAdult | turning;
+            handoff = true;
+        }
+    }
+
+    //Check that the values are possible
+    if (check){
+        correctVals = !(is_true(any(is_na(ModelBW))) || is_true(any(ModelBW <= 0.0)));
+    }
+
+    return List::create(Named("Time") = TIME,
+                        Named("Age") = AGE,
+                        Named("Fat_Free_Mass") = ModelFFM,
+                        Named("Fat_Mass") = ModelFM,
+                        Named("Body_Weight") = ModelBW,
+                        Named("Correct_Values")=correctVals,
+                        Named("Model_Type")="Life_Course");
+
+}
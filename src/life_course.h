@@ -0,0 +1,85 @@
+//
+//  life_course.h
+//
+//  This is a function that defines
+//  all the variables needed in life_course.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef life_course_h
+#define life_course_h
+
+#include <math.h>
+#include <Rcpp.h>
+#include "child_weight.h"
+#include "adult_weight.h"
+using namespace Rcpp;
+
+//Create a LifeCourse class that runs the Child model until each individual
+//turns 18 and the Adult model afterwards
+//--------------------------------------------------------------------------------
+class LifeCourse {
+public:
+
+    //Constructor with energy intake matrix for the child phase
+    LifeCourse(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+               NumericVector input_FFM, NumericVector input_FM, NumericVector input_ht,
+               NumericMatrix input_EIntake, NumericMatrix input_EIchange,
+               NumericMatrix input_NAchange, NumericVector input_PAL,
+               NumericVector input_pcarb_base, NumericVector input_pcarb,
+               double input_dt, bool checkValues);
+
+    //Constructor with reference energy intake for the child phase
+    LifeCourse(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+               NumericVector input_FFM, NumericVector input_FM, NumericVector input_ht,
+               NumericMatrix input_EIchange, NumericMatrix input_NAchange,
+               NumericVector input_PAL, NumericVector input_pcarb_base,
+               NumericVector input_pcarb, double input_dt, bool checkValues);
+
+    ~LifeCourse(void);
+
+    //Constants
+    NumericVector age;  //Age (yrs)
+    NumericVector FFM;  //Fat Free Mass (kg)
+    NumericVector FM;   //Fat Mass (kg)
+    bool          check; // Check values are correct
+
+    //Functions
+    //---------------------------------------------------------------------------
+    List rk4(double days);
+
+private:
+
+    //Age (yrs) at which an individual leaves the child model
+    double adult_age;
+    double dt;
+    int    nind;
+
+    //Models for each phase
+    Child child;
+    Adult adult;
+};
+
+
+#endif /* life_course_h */
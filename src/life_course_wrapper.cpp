@@ -0,0 +1,86 @@
+//
+//  life_course_wrapper.cpp
+//
+//  This is a function that uses Rcpp to return
+//  weight change from childhood into adulthood using the
+//  dynamic weight models by Kevin D. Hall et al.
+//
+//  Input:
+//  age             .-  Years since individual first arrived to Earth
+//  sex             .-  Either 1 = "female" or 0 = "male"
+//  bmiCat          .-  BMI category of the child (1 to 4)
+//  FFM             .-  Fat Free Mass (kg) of the individual
+//  FM              .-  Fat Mass (kg) of the individual
+//  ht              .-  Height (m) of the individual as an adult
+//  input_EIntake   .-  Energy intake (kcal) of individual per day while a child
+//  EIchange        .-  Change in energy intake (kcal) from adult baseline.
+//  NAchange        .-  Change in sodium consumption (mg) from adult baseline.
+//  PAL             .-  Physical activity level as an adult.
+//  pcarb_base      .-  Proportion of carbohydrates from diet at adult baseline.
+//  pcarb           .-  Proportion of carbohydrates from diet as an adult.
+//  days            .-  Days to model (integer)
+//  dt              .-  Time step used to solve the ODE system numerically
+//  Note:
+//  Please see life_course.cpp for additional information
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <Rcpp.h>
+#include "life_course.h"
+
+// [[Rcpp::export]]
+List life_course_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM,
+                         NumericVector FM, NumericVector ht, NumericMatrix input_EIntake,
+                         NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL,
+                         NumericVector pcarb_base, NumericVector pcarb, double days, double dt,
+                         bool checkValues){
+
+    profile_reset();
+
+    //Create new individuals with characteristics
+    LifeCourse Person (age, sex, bmiCat, FFM, FM, ht, input_EIntake, EIchange, NAchange,
+                       PAL, pcarb_base, pcarb, dt, checkValues);
+
+    //Run model using RK4
+    return profile_result(Person.rk4(days));
+
+}
+
+// [[Rcpp::export]]
+List life_course_wrapper_reference(NumericVector age, NumericVector sex, NumericVector bmiCat,
+                                   NumericVector FFM, NumericVector FM, NumericVector ht,
+                                   NumericMatrix EIchange, NumericMatrix NAchange, NumericVector PAL,
+                                   NumericVector pcarb_base, NumericVector pcarb, double days,
+                                   double dt, bool checkValues){
+
+    profile_reset();
+
+    //Create new individuals with characteristics
+    LifeCourse Person (age, sex, bmiCat, FFM, FM, ht, EIchange, NAchange, PAL, pcarb_base,
+                       pcarb, dt, checkValues);
+
+    //Run model using RK4
+    return profile_result(Person.rk4(days));
+
+}
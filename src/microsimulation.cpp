@@ -0,0 +1,458 @@
+//
+//  microsimulation.cpp
+//
+//  This is a function that projects weight change of an open population.
+//  Each year new children enter the population and individuals exit it
+//  according to a demographic table. Children are modelled with the
+//  children model and adults with the adult model by Kevin D. Hall et al;
+//  children are handed to the adult model when they turn 18 (see life_course.cpp).
+//
+//  Input:
+//  age             .-  Years since individual first arrived to Earth
+//  sex             .-  Either 1 = "female" or 0 = "male"
+//  bmiCat          .-  BMI category (1 to 4); only used for children
+//  FFM             .-  Fat Free Mass (kg); only used for children
+//  FM              .-  Fat Mass (kg); only used for children
+//  bw              .-  Body weight (kg); only used for adults
+//  ht              .-  Height (m) as an adult
+//  PAL             .-  Physical activity level as an adult
+//  pcarb_base      .-  Proportion of carbohydrates at adult baseline
+//  pcarb           .-  Proportion of carbohydrates as an adult
+//  entries         .-  Data frame with columns year, age, sex, bmiCat, ht, PAL,
+//                      pcarb_base, pcarb and n (number of children that enter)
+//  exit_rate       .-  Array (years x sex x age) of the probability of exiting
+//                      the population during the year
+//  dt              .-  Time step used to solve the ODE system numerically
+//  Note:
+//  Children follow the reference energy intake and adults keep their baseline
+//  energy intake so that the change in energy intake is zero for everyone.
+//  Only the live individuals are stored; the models of each year are built
+//  from the store and the results of each year are summarised before the next
+//  one starts.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "microsimulation.h"
+
+//Store
+//--------------------------------------------------------------------------------
+PopulationStore::PopulationStore(void){
+    nlive = 0;
+}
+
+PopulationStore::~PopulationStore(void){
+
+}
+
+//Add an individual in a free slot (or a new one) and return the slot
+int PopulationStore::add(double input_age, double input_sex, double input_bmiCat, double input_FFM,
+                         double input_FM, double input_ht, double input_PAL, double input_pcarb_base,
+                         double input_pcarb){
+
+    int slot;
+    if (freeslots.empty()){
+        slot = alive.size();
+        age.push_back(0.0); sex.push_back(0.0); bmiCat.push_back(0.0); ht.push_back(0.0);
+        PAL.push_back(0.0); pcarb_base.push_back(0.0); pcarb.push_back(0.0);
+        FFM.push_back(0.0); FM.push_back(0.0);
+        bw0.push_back(0.0); age0.push_back(0.0); fat0.push_back(0.0);
+        AT.push_back(0.0); ECF.push_back(0.0); GLY.push_back(0.0); L.push_back(0.0);
+        alive.push_back(0); adult.push_back(0);
+    } else {
+        slot = freeslots.back();
+        freeslots.pop_back();
+    }
+
+    age[slot]        = input_age;
+    sex[slot]        = input_sex;
+    bmiCat[slot]     = input_bmiCat;
+    FFM[slot]        = input_FFM;
+    FM[slot]         = input_FM;
+    ht[slot]         = input_ht;
+    PAL[slot]        = input_PAL;
+    pcarb_base[slot] = input_pcarb_base;
+    pcarb[slot]      = input_pcarb;
+    alive[slot]      = 1;
+    adult[slot]      = 0;
+    nlive++;
+
+    return slot;
+}
+
+//Free the slot of an individual that exits
+void PopulationStore::remove(int slot){
+    alive[slot] = 0;
+    freeslots.push_back(slot);
+    nlive--;
+}
+
+//Slots of the live individuals
+IntegerVector PopulationStore::live(void){
+    IntegerVector rows(nlive);
+    int k = 0;
+    for (int i = 0; i < (int) alive.size(); i++){
+        if (alive[i] == 1){
+            rows(k) = i;
+            k++;
+        }
+    }
+    return rows;
+}
+
+int PopulationStore::size(void){
+    return nlive;
+}
+
+int PopulationStore::capacity(void){
+    return alive.size();
+}
+
+//Microsimulation
+//--------------------------------------------------------------------------------
+Microsimulation::Microsimulation(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+                                 NumericVector input_FFM, NumericVector input_FM, NumericVector input_bw,
+                                 NumericVector input_ht, NumericVector input_PAL, NumericVector input_pcarb_base,
+                                 NumericVector input_pcarb, DataFrame input_entries, NumericVector input_exit_rate,
+                                 double input_dt, bool checkValues){
+
+    dt        = input_dt;
+    check     = checkValues;
+    adult_age = 18.0;
+    entries   = input_entries;
+    exit_rate = input_exit_rate;
+
+    IntegerVector dims = exit_rate.attr("dim");
+    maxyear = dims(0);
+    maxage  = dims(2) - 1;
+
+    //Add the initial population
+    IntegerVector slots(input_age.size());
+    for (int k = 0; k < input_age.size(); k++){
+        slots(k) = store.add(input_age(k), input_sex(k), input_bmiCat(k), input_FFM(k), input_FM(k),
+                             input_ht(k), input_PAL(k), input_pcarb_base(k), input_pcarb(k));
+    }
+
+    //Baseline of the adults
+    IntegerVector adultrows = which_true(input_age >= adult_age);
+    int nadult = adultrows.size();
+    if (nadult > 0){
+        NumericMatrix zero(2, nadult);
+        Adult adult(input_bw[adultrows], input_ht[adultrows], input_age[adultrows], input_sex[adultrows],
+                    zero, zero, input_PAL[adultrows], input_pcarb[adultrows],
+                    input_pcarb_base[adultrows], dt, check);
+        NumericMatrix State = adult.initState();
+        for (int k = 0; k < nadult; k++){
+            int s = slots(adultrows(k));
+            store.adult[s] = 1;
+            store.bw0[s]   = adult.bw(k);
+            store.age0[s]  = adult.age(k);
+            store.fat0[s]  = adult.fat(k);
+            store.AT[s]    = State(0,k);
+            store.ECF[s]   = State(1,k);
+            store.GLY[s]   = State(2,k);
+            store.L[s]     = State(3,k);
+            store.FM[s]    = adult.fat(k);
+            store.FFM[s]   = adult.bw(k) - adult.fat(k);
+        }
+    }
+}
+
+Microsimulation::~Microsimulation(void){
+
+}
+
+//Remove the individuals that exit during the year
+int Microsimulation::exits(int year){
+
+    if (year > maxyear){
+        return 0;
+    }
+
+    int nexit = 0;
+    IntegerVector rows = store.live();
+    for (int k = 0; k < rows.size(); k++){
+        int s = rows(k);
+        int a = std::min((int) floor(store.age[s]), maxage);
+        double p = exit_rate[(year - 1) + maxyear*((int) store.sex[s] + 2*a)];
+        if (p > 0.0 && R::runif(0.0, 1.0) < p){
+            store.remove(s);
+            nexit++;
+        }
+    }
+
+    return nexit;
+}
+
+//Add the children that enter during the year with their reference masses
+int Microsimulation::enter(int year){
+
+    NumericVector entry_year = entries["year"];
+    IntegerVector rows = which_true(entry_year == (double) year);
+    if (rows.size() == 0){
+        return 0;
+    }
+
+    NumericVector entry_age        = entries["age"];
+    NumericVector entry_sex        = entries["sex"];
+    NumericVector entry_bmiCat     = entries["bmiCat"];
+    NumericVector entry_ht         = entries["ht"];
+    NumericVector entry_PAL        = entries["PAL"];
+    NumericVector entry_pcarb_base = entries["pcarb_base"];
+    NumericVector entry_pcarb      = entries["pcarb"];
+    NumericVector entry_n          = entries["n"];
+
+    //Reference masses of each group
+    NumericVector age  = entry_age[rows];
+    NumericVector zero(rows.size());
+    Child reference(age, entry_sex[rows], entry_bmiCat[rows], zero, zero, dt, false);
+    NumericVector FFMref = reference.FFMReference(age);
+    NumericVector FMref  = reference.FMReference(age);
+
+    int nenter = 0;
+    for (int k = 0; k < rows.size(); k++){
+        int r = rows(k);
+        for (int j = 0; j < entry_n(r); j++){
+            store.add(entry_age(r), entry_sex(r), entry_bmiCat(r), FFMref(k), FMref(k), entry_ht(r),
+                      entry_PAL(r), entry_pcarb_base(r), entry_pcarb(r));
+            nenter++;
+        }
+    }
+
+    return nenter;
+}
+
+//Rungue Kutta 4 for one year of the live population
+bool Microsimulation::simulate_year(void){
+
+    IntegerVector rows = store.live();
+    int n = rows.size();
+    if (n == 0){
+        return true;
+    }
+
+    //Time steps of a year (365/dt is a whole number; see population_projection)
+    int nsims = (int) round(365.0/dt);
+
+    //Get the live individuals from the store. Children get a placeholder
+    //adult baseline that is replaced when they turn 18.
+    NumericVector Age(n), Sex(n), BMICat(n), Ht(n), Pal(n), Pcarb_base(n), Pcarb(n);
+    NumericVector FFM(n), FM(n), BW0(n), Age0(n), Fat0(n);
+    LogicalVector isAdult(n);
+    for (int k = 0; k < n; k++){
+        int s = rows(k);
+        Age(k)        = store.age[s];
+        Sex(k)        = store.sex[s];
+        BMICat(k)     = store.bmiCat[s];
+        Ht(k)         = store.ht[s];
+        Pal(k)        = store.PAL[s];
+        Pcarb_base(k) = store.pcarb_base[s];
+        Pcarb(k)      = store.pcarb[s];
+        FFM(k)        = store.FFM[s];
+        FM(k)         = store.FM[s];
+        isAdult(k)    = store.adult[s] == 1;
+        BW0(k)        = isAdult(k) ? store.bw0[s]  : FFM(k) + FM(k);
+        Age0(k)       = isAdult(k) ? store.age0[s] : Age(k);
+        Fat0(k)       = isAdult(k) ? store.fat0[s] : FM(k);
+    }
+
+    //Models of the year. Energy intake does not change so the adult model
+    //only needs two rows of changes and is solved from t = 0 at each step.
+    IntegerVector childrows = which_true(!isAdult);
+    int nchild = childrows.size();
+    NumericMatrix zero(2, n);
+    Adult adult(BW0, Ht, Age0, Sex, zero, zero, Pal, Pcarb, Pcarb_base, dt, Fat0, check, false);
+    Child child(Age[childrows], Sex[childrows], BMICat[childrows], FFM[childrows], FM[childrows], dt, check);
+
+    NumericMatrix AdultState = adult.initState();
+    for (int k = 0; k < n; k++){
+        if (isAdult(k)){
+            int s = rows(k);
+            AdultState(0,k) = store.AT[s];
+            AdultState(1,k) = store.ECF[s];
+            AdultState(2,k) = store.GLY[s];
+            AdultState(3,k) = store.L[s];
+        }
+    }
+
+    //Loop through the year
+    NumericVector ChildAge = clone(child.age);
+    NumericVector ChildFFM = clone(child.FFM);
+    NumericVector ChildFM  = clone(child.FM);
+    NumericMatrix ChildState, NewAdultState, Baseline;
+    NumericVector F, BW;
+    for (int i = 1; i <= nsims; i++){
+
+        //Children
+        if (nchild > 0){
+            ChildState = child.rk4_step(ChildAge, ChildFFM, ChildFM);
+            ChildFFM   = ChildState(0,_);
+            ChildFM    = ChildState(1,_);
+            ChildAge   = ChildAge + dt/365.0;
+            for (int k = 0; k < nchild; k++){
+                FFM(childrows(k)) = ChildFFM(k);
+                FM(childrows(k))  = ChildFM(k);
+            }
+        }
+
+        //Adults
+        NewAdultState = adult.rk4_step(0.0, AdultState);
+        for (int j = 0; j < 4; j++){
+            AdultState(j,_) = ifelse(isAdult, NewAdultState(j,_), AdultState(j,_));
+        }
+        F   = adult.fatMass(AdultState(3,_));
+        BW  = F + AdultState(3,_) + AdultState(1,_) + 3.7*AdultState(2,_);
+        FM  = ifelse(isAdult, F, FM);
+        FFM = ifelse(isAdult, BW - F, FFM);
+
+        //Update AGE variable
+        Age = Age + dt/365.0;
+
+        //Hand the children that turned 18 to the adult model
+        LogicalVector turning = !isAdult & (Age >= adult_age);
+        if (is_true(any(turning))){
+            Baseline = adult.rebase(turning, FFM + FM, Age, FM);
+            for (int j = 0; j < 4; j++){
+                AdultState(j,_) = ifelse(turning, Baseline(j,_), AdultState(j,_));
+            }
+            isAdult = isAdult | turning;
+        }
+    }
+
+    //Return the individuals to the store
+    for (int k = 0; k < n; k++){
+        int s = rows(k);
+        store.age[s]   = Age(k);
+        store.FFM[s]   = FFM(k);
+        store.FM[s]    = FM(k);
+        store.adult[s] = isAdult(k) ? 1 : 0;
+        if (isAdult(k)){
+            store.bw0[s]  = adult.bw(k);
+            store.age0[s] = adult.age(k);
+            store.fat0[s] = adult.fat(k);
+            store.AT[s]   = AdultState(0,k);
+            store.ECF[s]  = AdultState(1,k);
+            store.GLY[s]  = AdultState(2,k);
+            store.L[s]    = AdultState(3,k);
+        }
+    }
+
+    //Check that the values are possible
+    if (check){
+        NumericVector Weight = FFM + FM;
+        return !(is_true(any(is_na(Weight))) || is_true(any(Weight <= 0.0)));
+    }
+
+    return true;
+}
+
+//Run the microsimulation summarising each year
+List Microsimulation::run(int years, Nullable<Function> yearly){
+
+    IntegerVector Year(years), Population(years), Entries(years), Exits(years);
+    IntegerVector Children(years), Adults(years), Capacity(years);
+    NumericVector MeanBW(years), MeanFFM(years), MeanFM(years);
+
+    bool correctVals = true;
+    for (int y = 1; y <= years; y++){
+
+        //Demographic events happen at the start of the year
+        Exits(y-1)   = exits(y);
+        Entries(y-1) = enter(y);
+
+        //Weight change during the year
+        correctVals = simulate_year() && correctVals;
+
+        //Aggregates at the end of the year
+        IntegerVector rows = store.live();
+        int    nchild = 0;
+        double ffm    = 0.0;
+        double fm     = 0.0;
+        for (int k = 0; k < rows.size(); k++){
+            int s = rows(k);
+            nchild += 1 - store.adult[s];
+            ffm    += store.FFM[s];
+            fm     += store.FM[s];
+        }
+
+        Year(y-1)       = y;
+        Population(y-1) = rows.size();
+        Children(y-1)   = nchild;
+        Adults(y-1)     = rows.size() - nchild;
+        Capacity(y-1)   = store.capacity();
+        MeanFFM(y-1)    = rows.size() > 0 ? ffm/rows.size() : NA_REAL;
+        MeanFM(y-1)     = rows.size() > 0 ? fm/rows.size() : NA_REAL;
+        MeanBW(y-1)     = rows.size() > 0 ? (ffm + fm)/rows.size() : NA_REAL;
+
+        //Stream the year to the caller
+        if (yearly.isNotNull()){
+            Function f(yearly.get());
+            f(List::create(Named("Year") = Year(y-1),
+                           Named("Population") = Population(y-1),
+                           Named("Entries") = Entries(y-1),
+                           Named("Exits") = Exits(y-1),
+                           Named("Children") = Children(y-1),
+                           Named("Adults") = Adults(y-1),
+                           Named("Mean_Fat_Free_Mass") = MeanFFM(y-1),
+                           Named("Mean_Fat_Mass") = MeanFM(y-1),
+                           Named("Mean_Body_Weight") = MeanBW(y-1)));
+        }
+    }
+
+    //Live individuals at the end of the projection
+    IntegerVector rows = store.live();
+    int n = rows.size();
+    NumericVector Age(n), Sex(n), FFM(n), FM(n);
+    LogicalVector IsAdult(n);
+    for (int k = 0; k < n; k++){
+        int s = rows(k);
+        Age(k)   = store.age[s];
+        Sex(k)   = store.sex[s];
+        FFM(k)   = store.FFM[s];
+        FM(k)    = store.FM[s];
+        IsAdult(k) = store.adult[s] == 1;
+    }
+
+    List Aggregates = List::create(Named("Year") = Year,
+                                   Named("Population") = Population,
+                                   Named("Entries") = Entries,
+                                   Named("Exits") = Exits,
+                                   Named("Children") = Children,
+                                   Named("Adults") = Adults,
+                                   Named("Capacity") = Capacity,
+                                   Named("Mean_Fat_Free_Mass") = MeanFFM,
+                                   Named("Mean_Fat_Mass") = MeanFM,
+                                   Named("Mean_Body_Weight") = MeanBW);
+
+    List Individuals = List::create(Named("Age") = Age,
+                                    Named("Sex") = Sex,
+                                    Named("Adult") = IsAdult,
+                                    Named("Fat_Free_Mass") = FFM,
+                                    Named("Fat_Mass") = FM,
+                                    Named("Body_Weight") = FFM + FM);
+
+    return List::create(Named("Aggregates") = Aggregates,
+                        Named("Population") = Individuals,
+                        Named("Correct_Values") = correctVals);
+
+}
@@ -0,0 +1,135 @@
+//
+//  microsimulation.h
+//
+//  This is a function that defines
+//  all the variables needed in microsimulation.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef microsimulation_h
+#define microsimulation_h
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <Rcpp.h>
+#include "child_weight.h"
+#include "adult_weight.h"
+#include "population.h"
+using namespace Rcpp;
+
+//Growable store of the live individuals. Each variable is kept in its own
+//array (structure of arrays) and the slot of an individual that exits is
+//reused by the next one that enters so that the store only grows when the
+//live population does.
+//--------------------------------------------------------------------------------
+class PopulationStore {
+public:
+
+    PopulationStore(void);
+    ~PopulationStore(void);
+
+    //Characteristics of each slot
+    std::vector<double> age;         //Age (yrs)
+    std::vector<double> sex;         //0 = "male"; 1 = "female"
+    std::vector<double> bmiCat;      //BMI category of children (1 to 4)
+    std::vector<double> ht;          //Height as an adult (m)
+    std::vector<double> PAL;         //Physical activity level as an adult
+    std::vector<double> pcarb_base;  //Proportion of carbohydrates at adult baseline
+    std::vector<double> pcarb;       //Proportion of carbohydrates as an adult
+    std::vector<double> FFM;         //Fat Free Mass (kg)
+    std::vector<double> FM;          //Fat Mass (kg)
+
+    //Adult baseline (see Adult::rebase) and state (see Adult::rk4_step)
+    std::vector<double> bw0;
+    std::vector<double> age0;
+    std::vector<double> fat0;
+    std::vector<double> AT;
+    std::vector<double> ECF;
+    std::vector<double> GLY;
+    std::vector<double> L;
+
+    std::vector<int>    alive;
+    std::vector<int>    adult;
+
+    //Functions
+    //---------------------------------------------------------------------------
+    int  add(double input_age, double input_sex, double input_bmiCat, double input_FFM,
+             double input_FM, double input_ht, double input_PAL, double input_pcarb_base,
+             double input_pcarb);
+    void remove(int slot);
+    IntegerVector live(void);
+    int  size(void);
+    int  capacity(void);
+
+private:
+
+    std::vector<int> freeslots;  //Slots of individuals that exited
+    int nlive;
+};
+
+//Create a Microsimulation class for an open population where children enter
+//and individuals exit each year according to a demographic table
+//--------------------------------------------------------------------------------
+class Microsimulation {
+public:
+
+    //Constructor
+    Microsimulation(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+                    NumericVector input_FFM, NumericVector input_FM, NumericVector input_bw,
+                    NumericVector input_ht, NumericVector input_PAL, NumericVector input_pcarb_base,
+                    NumericVector input_pcarb, DataFrame input_entries, NumericVector input_exit_rate,
+                    double input_dt, bool checkValues);
+
+    ~Microsimulation(void);
+
+    bool check; // Check values are correct
+
+    //Functions
+    //---------------------------------------------------------------------------
+    List run(int years, Nullable<Function> yearly);
+
+private:
+
+    double dt;
+    double adult_age;
+
+    //Individuals
+    PopulationStore store;
+
+    //Entries (one row per group of new individuals) and exit probabilities
+    //by year, sex and age (array of years x 2 x ages)
+    DataFrame     entries;
+    NumericVector exit_rate;
+    int           maxyear;
+    int           maxage;
+
+    //Events and simulation of a year
+    int  exits(int year);
+    int  enter(int year);
+    bool simulate_year(void);
+};
+
+
+#endif /* microsimulation_h */
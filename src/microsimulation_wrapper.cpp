@@ -0,0 +1,69 @@
+//
+//  microsimulation_wrapper.cpp
+//
+//  This is a function that uses Rcpp to return
+//  the yearly projection of an open population using the
+//  dynamic weight models by Kevin D. Hall et al.
+//
+//  Input:
+//  age             .-  Years since individual first arrived to Earth
+//  sex             .-  Either 1 = "female" or 0 = "male"
+//  bmiCat          .-  BMI category (1 to 4); only used for children
+//  FFM             .-  Fat Free Mass (kg); only used for children
+//  FM              .-  Fat Mass (kg); only used for children
+//  bw              .-  Body weight (kg); only used for adults
+//  ht              .-  Height (m) as an adult
+//  PAL             .-  Physical activity level as an adult
+//  pcarb_base      .-  Proportion of carbohydrates at adult baseline
+//  pcarb           .-  Proportion of carbohydrates as an adult
+//  entries         .-  Children that enter the population each year
+//  exit_rate       .-  Probability of exiting by year, sex and age
+//  years           .-  Years to model (integer)
+//  dt              .-  Time step used to solve the ODE system numerically
+//  yearly          .-  Function called with the aggregates of each year (or NULL)
+//  Note:
+//  Please see microsimulation.cpp for additional information
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <Rcpp.h>
+#include "microsimulation.h"
+
+// [[Rcpp::export]]
+List microsimulation_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat,
+                             NumericVector FFM, NumericVector FM, NumericVector bw, NumericVector ht,
+                             NumericVector PAL, NumericVector pcarb_base, NumericVector pcarb,
+                             DataFrame entries, NumericVector exit_rate, int years, double dt,
+                             Nullable<Function> yearly, bool checkValues){
+
+    profile_reset();
+
+    //Create the initial population
+    Microsimulation Population (age, sex, bmiCat, FFM, FM, bw, ht, PAL, pcarb_base, pcarb,
+                                entries, exit_rate, dt, checkValues);
+
+    //Run model each year
+    return profile_result(Population.run(years, yearly));
+
+}
@@ -0,0 +1,194 @@
+//
+//  population.cpp
+//
+//  This is a function that calculates weight change for a population
+//  with children and adults. Individuals younger than 18 are modelled
+//  with the children model and the rest with the adult model by
+//  Kevin D. Hall et al. Both models are solved with Runge Kutta 4 in the
+//  same loop and their results are returned in the original order.
+//
+//  Input:
+//  age             .-  Years since individual first arrived to Earth
+//  sex             .-  Either 1 = "female" or 0 = "male"
+//  bmiCat          .-  BMI category (1 to 4); only used for children
+//  FFM             .-  Fat Free Mass (kg); only used for children
+//  FM              .-  Fat Mass (kg); only used for children
+//  bw              .-  Body weight (kg); only used for adults
+//  ht              .-  Height (m); only used for adults
+//  EIchange        .-  Change in energy intake (kcal) from baseline. For children
+//                      the baseline is the reference energy intake.
+//  NAchange        .-  Change in sodium consumption (mg); only used for adults
+//  PAL             .-  Physical activity level; only used for adults
+//  pcarb           .-  Proportion of carbohydrates after change; only used for adults
+//  pcarb_base      .-  Proportion of carbohydrates at baseline; only used for adults
+//  dt              .-  Time step used to solve the ODE system numerically
+//  Note:
+//  EIchange and NAchange have a row for each time step and a column for each
+//  individual.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "population.h"
+
+//Get the positions of the true values
+IntegerVector which_true(LogicalVector x){
+    int k = 0;
+    for (int i = 0; i < x.size(); i++){
+        if (x(i) == TRUE){
+            k++;
+        }
+    }
+    IntegerVector rows(k);
+    k = 0;
+    for (int i = 0; i < x.size(); i++){
+        if (x(i) == TRUE){
+            rows(k) = i;
+            k++;
+        }
+    }
+    return rows;
+}
+
+//Get the columns of a matrix
+static NumericMatrix subset_cols(NumericMatrix x, IntegerVector cols){
+    NumericMatrix sub(x.nrow(), cols.size());
+    for (int j = 0; j < cols.size(); j++){
+        sub(_,j) = x(_,cols(j));
+    }
+    return sub;
+}
+
+//Constructor
+Population::Population(NumericVector input_age, NumericVector input_sex, NumericVector input_bmiCat,
+                       NumericVector input_FFM, NumericVector input_FM, NumericVector input_bw,
+                       NumericVector input_ht, NumericMatrix input_EIchange, NumericMatrix input_NAchange,
+                       NumericVector input_PAL, NumericVector input_pcarb_base, NumericVector input_pcarb,
+                       double input_dt, bool checkValues) :
+    childrows(which_true(input_age < 18.0)),
+    adultrows(which_true(input_age >= 18.0)),
+    child(input_age[childrows], input_sex[childrows], input_bmiCat[childrows],
+          input_FFM[childrows], input_FM[childrows], subset_cols(input_EIchange, childrows),
+          input_dt, checkValues, true),
+    adult(input_bw[adultrows], input_ht[adultrows], input_age[adultrows], input_sex[adultrows],
+          subset_cols(input_EIchange, adultrows), subset_cols(input_NAchange, adultrows),
+          input_PAL[adultrows], input_pcarb[adultrows], input_pcarb_base[adultrows],
+          input_dt, checkValues){
+    age   = input_age;
+    dt    = input_dt;
+    check = checkValues;
+    nind  = age.size();
+}
+
+Population::~Population(void){
+
+}
+
+//Rungue Kutta 4 method for Population
+List Population::rk4(double days){
+
+    //Estimate number of elements to loop into
+    int nsims = floor(days/dt);
+    int nchild = childrows.size();
+    int nadult = adultrows.size();
+
+    //Create array of states
+    NumericMatrix ModelFFM(nind, nsims + 1); //in rcpp
+    NumericMatrix ModelFM(nind, nsims + 1); //in rcpp
+    NumericMatrix ModelBW(nind, nsims + 1); //in rcpp
+    NumericMatrix AGE(nind, nsims + 1); //in rcpp
+    NumericVector TIME(nsims + 1); //in rcpp
+
+    //States of each group
+    NumericVector ChildAge = clone(child.age);
+    NumericVector ChildFFM = clone(child.FFM);
+    NumericVector ChildFM  = clone(child.FM);
+    NumericMatrix ChildState;
+    NumericMatrix AdultState = adult.initState();
+    NumericVector F = adult.fatMass(AdultState(3,_));
+
+    //Create initial states
+    for (int k = 0; k < nchild; k++){
+        ModelFFM(childrows(k),0) = ChildFFM(k);
+        ModelFM(childrows(k),0)  = ChildFM(k);
+    }
+    for (int k = 0; k < nadult; k++){
+        ModelFM(adultrows(k),0)  = F(k);
+        ModelFFM(adultrows(k),0) = adult.bw(k) - F(k);
+    }
+    ModelBW(_,0)  = ModelFFM(_,0) + ModelFM(_,0);
+    TIME(0)  = 0.0;
+    AGE(_,0)  = age;
+
+    //Loop through all other states
+    bool correctVals = true;
+    NumericVector BW;
+    for (int i = 1; i <= nsims; i++){
+
+        //Children
+        if (nchild > 0){
+            ChildState = child.rk4_step(ChildAge, ChildFFM, ChildFM);
+            ChildFFM   = ChildState(0,_);
+            ChildFM    = ChildState(1,_);
+            ChildAge   = ChildAge + dt/365.0;
+            for (int k = 0; k < nchild; k++){
+                ModelFFM(childrows(k),i) = ChildFFM(k);
+                ModelFM(childrows(k),i)  = ChildFM(k);
+            }
+        }
+
+        //Adults
+        if (nadult > 0){
+            AdultState = adult.rk4_step(TIME(i-1), AdultState);
+            F  = adult.fatMass(AdultState(3,_));
+            BW = F + AdultState(3,_) + AdultState(1,_) + 3.7*AdultState(2,_);
+            for (int k = 0; k < nadult; k++){
+                ModelFM(adultrows(k),i)  = F(k);
+                ModelFFM(adultrows(k),i) = BW(k) - F(k);
+            }
+        }
+
+        //Update weight
+        ModelBW(_,i) = ModelFFM(_,i) + ModelFM(_,i);
+
+        //Update TIME(i-1)
+        TIME(i) = TIME(i-1) + dt; // Currently time counts the time (days) passed since start of model
+
+        //Update AGE variable
+        AGE(_,i) = AGE(_,i-1) + dt/365.0; //Age is variable in years
+    }
+
+    //Check that the values are possible
+    if (check){
+        correctVals = !(is_true(any(is_na(ModelBW))) || is_true(any(ModelBW <= 0.0)));
+    }
+
+    return List::create(Named("Time") = TIME,
+                        Named("Age") = AGE,
+                        Named("Fat_Free_Mass") = ModelFFM,
+                        Named("Fat_Mass") = ModelFM,
+                        Named("Body_Weight") = ModelBW,
+                        Named("Correct_Values")=correctVals,
+                        Named("Model_Type")="Population");
+
+}
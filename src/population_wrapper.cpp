@@ -0,0 +1,67 @@
+//
+//  population_wrapper.cpp
+//
+//  This is a function that uses Rcpp to return
+//  weight change for a population of children and adults
+//  using the dynamic weight models by Kevin D. Hall et al.
+//
+//  Input:
+//  age             .-  Years since individual first arrived to Earth
+//  sex             .-  Either 1 = "female" or 0 = "male"
+//  bmiCat          .-  BMI category (1 to 4); only used for children
+//  FFM             .-  Fat Free Mass (kg); only used for children
+//  FM              .-  Fat Mass (kg); only used for children
+//  bw              .-  Body weight (kg); only used for adults
+//  ht              .-  Height (m); only used for adults
+//  EIchange        .-  Change in energy intake (kcal) from baseline.
+//  NAchange        .-  Change in sodium consumption (mg); only used for adults
+//  PAL             .-  Physical activity level; only used for adults
+//  pcarb_base      .-  Proportion of carbohydrates at baseline; only used for adults
+//  pcarb           .-  Proportion of carbohydrates after change; only used for adults
+//  days            .-  Days to model (integer)
+//  dt              .-  Time step used to solve the ODE system numerically
+//  Note:
+//  Please see population.cpp for additional information
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <Rcpp.h>
+#include "population.h"
+
+// [[Rcpp::export]]
+List population_wrapper(NumericVector age, NumericVector sex, NumericVector bmiCat, NumericVector FFM,
+                        NumericVector FM, NumericVector bw, NumericVector ht, NumericMatrix EIchange,
+                        NumericMatrix NAchange, NumericVector PAL, NumericVector pcarb_base,
+                        NumericVector pcarb, double days, double dt, bool checkValues){
+
+    profile_reset();
+
+    //Create new population with characteristics
+    Population People (age, sex, bmiCat, FFM, FM, bw, ht, EIchange, NAchange, PAL, pcarb_base,
+                       pcarb, dt, checkValues);
+
+    //Run model using RK4
+    return profile_result(People.rk4(days));
+
+}
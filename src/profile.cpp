@@ -0,0 +1,139 @@
+//
+//  profile.cpp
+//
+//  Instrumentation of the models (see profile.h): wall time of each phase,
+//  counters and a trace of events that is returned as the Profile attribute
+//  of the results. It is compiled out unless the package is built with
+//  -DBW_PROFILE.
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "profile.h"
+
+#ifdef BW_PROFILE
+
+std::chrono::steady_clock::time_point      Profiler::origin = std::chrono::steady_clock::now();
+std::map<std::string, Profiler::Phase>     Profiler::phases;
+std::map<std::string, double>              Profiler::counters;
+std::vector<Profiler::Event>               Profiler::events;
+int                                        Profiler::dropped = 0;
+
+//Profiler
+//--------------------------------------------------------------------------------
+void Profiler::reset(void){
+    origin  = std::chrono::steady_clock::now();
+    dropped = 0;
+    phases.clear();
+    counters.clear();
+    events.clear();
+}
+
+double Profiler::now(void){
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Profiler::phase(std::string name, double start, double end){
+    Phase& current   = phases[name];
+    current.calls   += 1;
+    current.seconds += (end - start)/1e6;
+    if (events.size() < (size_t) PROFILE_EVENTS){
+        Event event = {name, start, end - start};
+        events.push_back(event);
+    } else {
+        dropped++;
+    }
+}
+
+void Profiler::count(std::string name, double n){
+    counters[name] += n;
+}
+
+//Phases (calls and seconds), counters and events of the run
+List Profiler::result(void){
+    CharacterVector phase_name(phases.size());
+    IntegerVector   phase_calls(phases.size());
+    NumericVector   phase_seconds(phases.size());
+    int k = 0;
+    for (std::map<std::string, Phase>::iterator it = phases.begin(); it != phases.end(); ++it, k++){
+        phase_name(k)    = it->first;
+        phase_calls(k)   = it->second.calls;
+        phase_seconds(k) = it->second.seconds;
+    }
+
+    NumericVector counter_values(counters.size());
+    CharacterVector counter_names(counters.size());
+    k = 0;
+    for (std::map<std::string, double>::iterator it = counters.begin(); it != counters.end(); ++it, k++){
+        counter_names(k)  = it->first;
+        counter_values(k) = it->second;
+    }
+    counter_values.attr("names") = counter_names;
+
+    CharacterVector event_name(events.size());
+    NumericVector   event_start(events.size());
+    NumericVector   event_duration(events.size());
+    for (size_t e = 0; e < events.size(); e++){
+        event_name(e)     = events[e].name;
+        event_start(e)    = events[e].start;
+        event_duration(e) = events[e].duration;
+    }
+
+    return List::create(Named("Phases")   = DataFrame::create(Named("Phase")   = phase_name,
+                                                                Named("Calls")   = phase_calls,
+                                                                Named("Seconds") = phase_seconds,
+                                                                Named("stringsAsFactors") = false),
+                        Named("Counters") = counter_values,
+                        Named("Events")   = DataFrame::create(Named("Name")     = event_name,
+                                                                Named("Start")    = event_start,
+                                                                Named("Duration") = event_duration,
+                                                                Named("stringsAsFactors") = false),
+                        Named("Dropped_Events") = dropped);
+}
+
+//ProfileScope
+//--------------------------------------------------------------------------------
+ProfileScope::ProfileScope(const char* input_name){
+    name  = input_name;
+    start = Profiler::now();
+}
+
+ProfileScope::~ProfileScope(void){
+    Profiler::phase(name, start, Profiler::now());
+}
+
+#endif
+
+void profile_reset(void){
+#ifdef BW_PROFILE
+    Profiler::reset();
+#endif
+}
+
+List profile_result(List result){
+#ifdef BW_PROFILE
+    result.attr("Profile") = Profiler::result();
+    Profiler::reset();
+#endif
+    return result;
+}
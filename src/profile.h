@@ -0,0 +1,116 @@
+//
+//  profile.h
+//
+//  This is a function that defines
+//  the instrumentation in profile.cpp: time of each phase of the models,
+//  counters and a trace of events. It is compiled out unless the package is
+//  built with -DBW_PROFILE (e.g. PKG_CPPFLAGS = -DBW_PROFILE in ~/.R/Makevars)
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef profile_h
+#define profile_h
+
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+#ifdef BW_PROFILE
+
+//Maximum number of events kept for the trace (the phases and counters are
+//always complete)
+const int PROFILE_EVENTS = 100000;
+
+//Create a Profiler class with the time of each phase, the counters and
+//the events of a run
+//--------------------------------------------------------------------------------
+class Profiler {
+public:
+
+    //Functions
+    //---------------------------------------------------------------------------
+    static void   reset(void);
+    static double now(void);                                   //Microseconds since reset
+    static void   phase(std::string name, double start, double end);
+    static void   count(std::string name, double n);
+    static List   result(void);
+
+private:
+
+    struct Phase {
+        int    calls;
+        double seconds;
+    };
+
+    struct Event {
+        std::string name;
+        double      start;     //Microseconds
+        double      duration;  //Microseconds
+    };
+
+    static std::chrono::steady_clock::time_point origin;
+    static std::map<std::string, Phase>          phases;
+    static std::map<std::string, double>         counters;
+    static std::vector<Event>                    events;
+    static int                                   dropped;
+};
+
+//Create a ProfileScope class that times the phase of the scope where it lives
+//--------------------------------------------------------------------------------
+class ProfileScope {
+public:
+
+    ProfileScope(const char* input_name);
+    ~ProfileScope(void);
+
+private:
+
+    const char* name;
+    double      start;
+};
+
+#define PROFILE_JOIN(a, b) a##b
+#define PROFILE_NAME(line) PROFILE_JOIN(profile_scope_, line)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_NAME(__LINE__)(name)
+#define PROFILE_COUNT(name, n) Profiler::count(name, n)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNT(name, n)
+
+#endif
+
+//Start the instrumentation of a run (nothing without BW_PROFILE)
+void profile_reset(void);
+
+//Results of a run with the Profile attribute (unchanged without BW_PROFILE)
+List profile_result(List result);
+
+
+#endif /* profile_h */
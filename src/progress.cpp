@@ -0,0 +1,86 @@
+//
+//  progress.cpp
+//
+//  Progress reports and cooperative cancellation of the models (see progress.h).
+//  The user interrupt is checked without leaving the model so that it can
+//  return the results up to the time step where it stopped.
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "progress.h"
+
+//R_CheckUserInterrupt jumps out of the model; it is run on its own context
+static void check_interrupt(void* data){
+    R_CheckUserInterrupt();
+}
+
+Progress::Progress(Nullable<Function> input_callback, double input_interval){
+    callback = input_callback;
+    interval = input_interval;
+    start    = std::chrono::steady_clock::now();
+    last     = start;
+    stop     = false;
+}
+
+Progress::~Progress(void){
+
+}
+
+bool Progress::interrupted(void){
+    return R_ToplevelExec(check_interrupt, NULL) == FALSE;
+}
+
+//Report the individual time steps done out of total. Returns false if the run
+//was interrupted by the user or cancelled by the callback (returning FALSE).
+bool Progress::update(double done, double total){
+
+    if (stop){
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - last).count() < interval && done < total){
+        return true;
+    }
+    last = now;
+
+    if (interrupted()){
+        stop = true;
+        return false;
+    }
+
+    if (callback.isNotNull()){
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        double rate    = elapsed > 0 ? done/elapsed : NA_REAL;
+        SEXP   report  = Function(callback.get())(List::create(Named("Fraction") = done/total,
+                                                         Named("Steps")    = done,
+                                                         Named("Rate")     = rate,
+                                                         Named("ETA")      = (total - done)/rate));
+        if (TYPEOF(report) == LGLSXP && Rf_length(report) == 1 && LOGICAL(report)[0] == FALSE){
+            stop = true;
+        }
+    }
+
+    return !stop;
+}
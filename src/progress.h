@@ -0,0 +1,65 @@
+//
+//  progress.h
+//
+//  This is a function that defines
+//  the progress reports and cancellation of the models in progress.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef progress_h
+#define progress_h
+
+#include <chrono>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//Create a Progress class that reports how far along a model is and checks
+//whether the user interrupted it. The checks are done at most once per
+//interval so that they do not slow down the time steps.
+//--------------------------------------------------------------------------------
+class Progress {
+public:
+
+    Progress(Nullable<Function> input_callback, double input_interval);
+    ~Progress(void);
+
+    //Functions
+    //---------------------------------------------------------------------------
+    bool update(double done, double total);  //Individual time steps; false if cancelled
+
+private:
+
+    Nullable<Function> callback;  //Called with the Fraction, Steps, Rate and ETA
+    double             interval;  //Seconds between reports
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point last;
+    bool                                  stop;      //Once cancelled the run stays so
+
+    bool interrupted(void);
+};
+
+
+#endif /* progress_h */
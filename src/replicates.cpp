@@ -0,0 +1,131 @@
+//
+//  replicates.cpp
+//
+//  This is a function that gets the weighted means and variances of each
+//  group at each time step for the full sample weights and for every
+//  replicate weight of a survey (bootstrap, jackknife or BRR). The replicate
+//  standard errors are computed from them in model_mean.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <vector>
+#include <algorithm>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//Individuals of a block: their weights of all the replicates stay in cache
+//while every time step is swept
+const int REPLICATE_BLOCK = 256;
+
+//Weighted means and variances of a matrix with a row for each individual (x)
+//for each column of weights (the full sample weights and then the replicates).
+//The rows are sorted by group and the individuals of group g are the rows
+//starts(g) to starts(g + 1) - 1. Sums are taken like a matrix product of the
+//weights and the values by blocks of individuals; the values are shifted by
+//the first value of the group so that the sums of squares are accurate. The
+//variance is that of svyvar (with an n/(n - 1) correction). Returns arrays of
+//weights x time x group.
+// [[Rcpp::export]]
+List replicate_wrapper(NumericMatrix x, NumericMatrix weights, IntegerVector starts){
+
+    int ntimes   = x.ncol();
+    int nweights = weights.ncol();
+    int ngroups  = starts.size() - 1;
+    int nind     = x.nrow();
+
+    const double* values = x.begin();
+    const double* w      = weights.begin();
+
+    NumericVector Mean((size_t) nweights*ntimes*ngroups);
+    NumericVector Variance((size_t) nweights*ntimes*ngroups);
+
+    std::vector<double> S0(nweights);
+    std::vector<double> S1((size_t) nweights*ntimes);
+    std::vector<double> S2((size_t) nweights*ntimes);
+    std::vector<double> shifted(REPLICATE_BLOCK);
+    std::vector<double> squared(REPLICATE_BLOCK);
+
+    for (int g = 0; g < ngroups; g++){
+
+        int first = starts(g);
+        int last  = starts(g + 1);
+        std::fill(S0.begin(), S0.end(), 0.0);
+        std::fill(S1.begin(), S1.end(), 0.0);
+        std::fill(S2.begin(), S2.end(), 0.0);
+
+        for (int r = 0; r < nweights; r++){
+            for (int i = first; i < last; i++){
+                S0[r] += w[i + (size_t) nind*r];
+            }
+        }
+
+        for (int block = first; block < last; block += REPLICATE_BLOCK){
+            int end = std::min(block + REPLICATE_BLOCK, last);
+            for (int t = 0; t < ntimes; t++){
+                const double* column = values + (size_t) nind*t;
+                double shift = column[first];
+                for (int i = block; i < end; i++){
+                    shifted[i - block] = column[i] - shift;
+                    squared[i - block] = shifted[i - block]*shifted[i - block];
+                }
+                for (int r = 0; r < nweights; r++){
+                    const double* wr = w + (size_t) nind*r + block;
+                    double sum1 = 0.0;
+                    double sum2 = 0.0;
+                    for (int i = 0; i < end - block; i++){
+                        sum1 += wr[i]*shifted[i];
+                        sum2 += wr[i]*squared[i];
+                    }
+                    S1[r + (size_t) nweights*t] += sum1;
+                    S2[r + (size_t) nweights*t] += sum2;
+                }
+            }
+        }
+
+        double n = last - first;
+        for (int t = 0; t < ntimes; t++){
+            double shift = last > first ? values[first + (size_t) nind*t] : 0.0;
+            for (int r = 0; r < nweights; r++){
+                size_t cell  = r + (size_t) nweights*(t + (size_t) ntimes*g);
+                double sum1  = S1[r + (size_t) nweights*t];
+                double sum2  = S2[r + (size_t) nweights*t];
+                if (S0[r] <= 0){
+                    Mean[cell]     = NA_REAL;
+                    Variance[cell] = NA_REAL;
+                    continue;
+                }
+                Mean[cell]     = shift + sum1/S0[r];
+                Variance[cell] = n > 1 ? (sum2 - sum1*sum1/S0[r])/S0[r]*n/(n - 1.0) : NA_REAL;
+            }
+        }
+    }
+
+    IntegerVector dim = IntegerVector::create(nweights, ntimes, ngroups);
+    Mean.attr("dim")     = dim;
+    Variance.attr("dim") = dim;
+
+    return List::create(Named("Mean")     = Mean,
+                        Named("Variance") = Variance);
+}
@@ -0,0 +1,92 @@
+//
+//  shard.cpp
+//
+//  This is a function that splits a population into shards by a hash of
+//  the identifier of each individual and gets the partial moments (weight,
+//  mean and sum of squared deviations) of each group at each time step of
+//  a shard. The moments of the shards are merged in model_merge.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//64 bit FNV-1a hash of a string (the same in every platform and session)
+static uint64_t fnv1a(const char* x){
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char* c = (const unsigned char*) x; *c != 0; c++){
+        hash ^= (uint64_t) *c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//Shard (1 to shards) of each identifier
+// [[Rcpp::export]]
+IntegerVector shard_wrapper(CharacterVector id, int shards){
+    IntegerVector shard(id.size());
+    for (int i = 0; i < id.size(); i++){
+        shard(i) = (int) (fnv1a(CHAR(STRING_ELT(id, i))) % (uint64_t) shards) + 1;
+    }
+    return shard;
+}
+
+//Weighted moments of each group (rows) at each time step (columns) of a matrix
+//with a row for each individual. The mean and the sum of squared deviations are
+//updated one individual at a time (West's algorithm) so that they are accurate
+//even for large shards. Missing values are skipped.
+// [[Rcpp::export]]
+List moments_wrapper(NumericMatrix x, IntegerVector group, int ngroups, NumericVector weights){
+
+    int nind   = x.nrow();
+    int ntimes = x.ncol();
+
+    NumericMatrix W(ngroups, ntimes);
+    NumericMatrix N(ngroups, ntimes);
+    NumericMatrix Mean(ngroups, ntimes);
+    NumericMatrix M2(ngroups, ntimes);
+
+    for (int t = 0; t < ntimes; t++){
+        for (int i = 0; i < nind; i++){
+            double value = x(i, t);
+            double w     = weights(i);
+            if (ISNAN(value) || w <= 0){
+                continue;
+            }
+            int g = group(i) - 1;
+            W(g, t)     += w;
+            N(g, t)     += 1;
+            double delta = value - Mean(g, t);
+            Mean(g, t)  += delta*w/W(g, t);
+            M2(g, t)    += w*delta*(value - Mean(g, t));
+        }
+    }
+
+    return List::create(Named("W")    = W,
+                        Named("N")    = N,
+                        Named("Mean") = Mean,
+                        Named("M2")   = M2);
+}
@@ -0,0 +1,416 @@
+//
+//  shared.cpp
+//
+//  This is a function that writes the results of the models to a POSIX
+//  shared memory segment (sink = "shared") and reads them from another
+//  process, even while the model is still running. See shared.h for
+//  the layout of a segment.
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "shared.h"
+#include "profile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#if !defined(_WIN32) && R_VERSION >= R_Version(3, 5, 0)
+#define SHARED_ALTREP
+#if R_VERSION < R_Version(3, 6, 0)
+//R 3.5 headers use class as a variable name
+#define class klass
+extern "C" {
+#include <R_ext/Altrep.h>
+}
+#undef class
+#else
+#include <R_ext/Altrep.h>
+#endif
+#endif
+
+//Name of a segment as a POSIX shared memory object ("/name")
+std::string shared_name(std::string name){
+    if (name.empty() || name[0] != '/'){
+        name = "/" + name;
+    }
+    if (name.size() < 2 || name.find('/', 1) != std::string::npos){
+        stop("Invalid name of the shared memory segment: '" + name + "'.");
+    }
+    return name;
+}
+
+#ifndef _WIN32
+
+//Shared memory object of a segment. In Linux these are the files of /dev/shm
+//(which is what shm_open opens) so the package does not need librt; they are
+//never opened through a symbolic link.
+static int shared_open(std::string name, int flags){
+#ifdef __linux__
+    return open(("/dev/shm" + name).c_str(), flags | O_NOFOLLOW, 0600);
+#else
+    return shm_open(name.c_str(), flags, 0600);
+#endif
+}
+
+static int shared_unlink(std::string name){
+#ifdef __linux__
+    return unlink(("/dev/shm" + name).c_str());
+#else
+    return shm_unlink(name.c_str());
+#endif
+}
+
+#endif
+
+//SinkShared
+//--------------------------------------------------------------------------------
+SinkShared::SinkShared(std::string input_name){
+#ifdef _WIN32
+    stop("Shared memory segments need a POSIX system (e.g. Linux or macOS).");
+#endif
+    name    = shared_name(input_name);
+    nind    = 0;
+    ntimes  = 0;
+    size    = 0;
+    segment = NULL;
+}
+
+SinkShared::~SinkShared(void){
+#ifndef _WIN32
+    if (segment != NULL){
+        SharedHeader* header = (SharedHeader*) segment;
+        __atomic_store_n(&header->finished, (int64_t) 1, __ATOMIC_RELEASE);
+        munmap(segment, size);
+    }
+#endif
+}
+
+//Variable recorded for nind individuals (of the whole run) and ntimes time steps
+void SinkShared::add(std::string variable, int input_nind, int input_ntimes){
+    for (size_t k = 0; k < variables.size(); k++){
+        if (variables[k] == variable){
+            return; //Added by a previous block
+        }
+    }
+    if (segment != NULL){
+        stop("Cannot add variable '" + variable + "' to a shared memory segment in use.");
+    }
+    if (variable.size() >= SHARED_NAME){
+        stop("Variable name '" + variable + "' is too long for a shared memory segment.");
+    }
+    nind   = input_nind;
+    ntimes = input_ntimes;
+    variables.push_back(variable);
+}
+
+void SinkShared::create(void){
+#ifndef _WIN32
+    size_t nvars  = variables.size();
+    size_t start  = sizeof(SharedHeader) + nvars*sizeof(SharedVariable);
+    size_t values = (size_t) nind*ntimes*sizeof(double);
+    size_t counts = (size_t) ntimes*sizeof(int64_t);
+    size = start + nvars*(values + counts);
+
+    //A previous segment of the same name is unlinked rather than truncated:
+    //readers that still map it keep its pages and the new segment is created
+    //exclusively so it cannot be someone else's object
+    shared_unlink(name);
+    int fd = shared_open(name, O_RDWR | O_CREAT | O_EXCL);
+    if (fd < 0){
+        stop("Cannot create the shared memory segment '" + name + "'.");
+    }
+    if (ftruncate(fd, size) != 0){
+        close(fd);
+        stop("Cannot allocate the shared memory segment '" + name + "'.");
+    }
+    void* address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED){
+        stop("Cannot map the shared memory segment '" + name + "'.");
+    }
+    segment = (unsigned char*) address;
+    PROFILE_COUNT("bytes_allocated", (double) size);
+
+    //Header and variables (the values and counts start as zeros)
+    SharedHeader* header = (SharedHeader*) segment;
+    memcpy(header->magic, SHARED_MAGIC, 8);
+    header->version  = SHARED_VERSION;
+    header->nvars    = (int32_t) nvars;
+    header->nind     = nind;
+    header->ntimes   = ntimes;
+    header->finished = 0;
+    SharedVariable* directory = (SharedVariable*) (segment + sizeof(SharedHeader));
+    for (size_t k = 0; k < nvars; k++){
+        strncpy(directory[k].name, variables[k].c_str(), SHARED_NAME - 1);
+        directory[k].offset = (int64_t) (start + k*values);
+        directory[k].counts = (int64_t) (start + nvars*values + k*counts);
+    }
+#endif
+}
+
+//Values of individuals first, first + 1, ... at a recorded time step (column)
+void SinkShared::write(std::string variable, int first, int column, NumericVector x){
+    if (segment == NULL){
+        create();
+    }
+    SharedVariable* directory = (SharedVariable*) (segment + sizeof(SharedHeader));
+    for (size_t k = 0; k < variables.size(); k++){
+        if (variables[k] == variable){
+            double*  values = (double*) (segment + directory[k].offset);
+            int64_t* counts = (int64_t*) (segment + directory[k].counts);
+            std::copy(x.begin(), x.end(), values + (size_t) column*nind + first);
+            __atomic_fetch_add(&counts[column], (int64_t) x.size(), __ATOMIC_RELEASE);
+            PROFILE_COUNT("bytes_written", 8.0*x.size());
+            return;
+        }
+    }
+}
+
+#ifndef _WIN32
+
+//Mapping of a segment read by R: an external pointer to its address whose
+//finalizer unmaps it once nothing refers to it
+static void shared_unmap(SEXP mapping){
+    void* address = R_ExternalPtrAddr(mapping);
+    if (address != NULL){
+        munmap(address, (size_t) REAL(R_ExternalPtrProtected(mapping))[0]);
+        R_ClearExternalPtr(mapping);
+    }
+}
+
+#endif
+
+#ifdef SHARED_ALTREP
+
+//The matrix of a variable (data1) is a list with the mapping of the segment,
+//the offset of its values and its length. Its values are read from the segment
+//(mapped read only) and only copied (data2) if R asks for memory it can write.
+static R_altrep_class_t shared_class;
+
+static R_xlen_t shared_length(SEXP x){
+    return (R_xlen_t) REAL(VECTOR_ELT(R_altrep_data1(x), 2))[0];
+}
+
+static const double* shared_values(SEXP x){
+    SEXP definition = R_altrep_data1(x);
+    const unsigned char* segment = (const unsigned char*) R_ExternalPtrAddr(VECTOR_ELT(definition, 0));
+    return (const double*) (segment + (size_t) REAL(VECTOR_ELT(definition, 1))[0]);
+}
+
+static void* shared_dataptr(SEXP x, Rboolean writeable){
+    SEXP values = R_altrep_data2(x);
+    if (values == R_NilValue && !writeable){
+        return (void*) shared_values(x);
+    }
+    if (values == R_NilValue){
+        R_xlen_t n = shared_length(x);
+        values = PROTECT(Rf_allocVector(REALSXP, n));
+        std::copy(shared_values(x), shared_values(x) + n, REAL(values));
+        R_set_altrep_data2(x, values);
+        UNPROTECT(1);
+    }
+    return REAL(values);
+}
+
+static const void* shared_dataptr_or_null(SEXP x){
+    SEXP values = R_altrep_data2(x);
+    if (values == R_NilValue){
+        return shared_values(x);
+    }
+    return REAL(values);
+}
+
+static double shared_elt(SEXP x, R_xlen_t i){
+    return ((const double*) shared_dataptr_or_null(x))[i];
+}
+
+static R_xlen_t shared_get_region(SEXP x, R_xlen_t start, R_xlen_t size, double* buffer){
+    R_xlen_t      n      = std::min(size, shared_length(x) - start);
+    const double* values = (const double*) shared_dataptr_or_null(x);
+    std::copy(values + start, values + start + n, buffer);
+    return n;
+}
+
+//A duplicate is an ordinary vector with the values read
+static SEXP shared_duplicate(SEXP x, Rboolean deep){
+    R_xlen_t      n      = shared_length(x);
+    const double* values = (const double*) shared_dataptr_or_null(x);
+    SEXP copy = PROTECT(Rf_allocVector(REALSXP, n));
+    std::copy(values, values + n, REAL(copy));
+    UNPROTECT(1);
+    return copy;
+}
+
+static Rboolean shared_inspect(SEXP x, int pre, int deep, int pvec,
+                               void (*inspect_subtree)(SEXP, int, int, int)){
+    Rprintf("shared memory matrix (%s)\n", R_altrep_data2(x) == R_NilValue ? "mapped" : "copied");
+    return TRUE;
+}
+
+#endif
+
+// [[Rcpp::init]]
+void shared_init(DllInfo* dll){
+#ifdef SHARED_ALTREP
+    shared_class = R_make_altreal_class("shared_matrix", "bw", dll);
+    R_set_altrep_Length_method(shared_class, shared_length);
+    R_set_altrep_Inspect_method(shared_class, shared_inspect);
+    R_set_altrep_Duplicate_method(shared_class, shared_duplicate);
+    R_set_altvec_Dataptr_method(shared_class, shared_dataptr);
+    R_set_altvec_Dataptr_or_null_method(shared_class, shared_dataptr_or_null);
+    R_set_altreal_Elt_method(shared_class, shared_elt);
+    R_set_altreal_Get_region_method(shared_class, shared_get_region);
+#endif
+}
+
+//Read a segment: the individual x time matrix of each of the variables (all if
+//none are given), how many of their values were written, which of their time
+//steps are complete and whether the model finished. The matrices point to the
+//segment mapped read only, which stays mapped while any of them is in use;
+//without ALTREP (R < 3.5) they are copied.
+// [[Rcpp::export]]
+List shared_wrapper(std::string name, CharacterVector variables, bool remove){
+#ifdef _WIN32
+    stop("Shared memory segments need a POSIX system (e.g. Linux or macOS).");
+    return List::create();
+#else
+    name = shared_name(name);
+    int fd = shared_open(name, O_RDONLY);
+    if (fd < 0){
+        stop("Cannot open the shared memory segment '" + name + "'.");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(SharedHeader)){
+        close(fd);
+        stop("Invalid shared memory segment '" + name + "'.");
+    }
+    size_t size    = info.st_size;
+    void*  address = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED){
+        stop("Cannot map the shared memory segment '" + name + "'.");
+    }
+    NumericVector length  = NumericVector::create((double) size);
+    RObject       mapping = R_MakeExternalPtr(address, R_NilValue, length);
+    R_RegisterCFinalizerEx(mapping, shared_unmap, TRUE);
+    const unsigned char* segment = (const unsigned char*) address;
+
+    //The header, the variables and the values and counts of each of them must
+    //be in the segment before any of them is read. They are copied first as
+    //the segment can be written while it is read.
+    SharedHeader header;
+    memcpy(&header, segment, sizeof(SharedHeader));
+    bool valid = memcmp(header.magic, SHARED_MAGIC, 8) == 0 && header.version == SHARED_VERSION &&
+                 header.nvars >= 0 && header.nind >= 0 && header.ntimes >= 0 &&
+                 header.nind <= INT_MAX && header.ntimes <= INT_MAX &&
+                 (size_t) header.nvars <= (size - sizeof(SharedHeader))/sizeof(SharedVariable);
+    size_t bytes  = 0;
+    size_t counts = valid ? (size_t) header.ntimes*sizeof(int64_t) : 0;
+    if (valid){
+        valid = header.ntimes == 0 || (size_t) header.nind <= size/sizeof(double)/header.ntimes;
+        bytes = valid ? (size_t) header.nind*header.ntimes*sizeof(double) : 0;
+    }
+    std::vector<SharedVariable> directory(valid ? header.nvars : 0);
+    if (valid && header.nvars > 0){
+        memcpy(&directory[0], segment + sizeof(SharedHeader), header.nvars*sizeof(SharedVariable));
+    }
+    for (size_t k = 0; valid && k < directory.size(); k++){
+        valid = directory[k].offset >= 0 && (uint64_t) directory[k].offset <= size &&
+                directory[k].offset % sizeof(double) == 0 &&
+                bytes <= size - (size_t) directory[k].offset &&
+                directory[k].counts >= 0 && (uint64_t) directory[k].counts <= size &&
+                directory[k].counts % sizeof(int64_t) == 0 &&
+                counts <= size - (size_t) directory[k].counts &&
+                memchr(directory[k].name, '\0', SHARED_NAME) != NULL;
+    }
+    if (!valid){
+        shared_unmap(mapping);
+        stop("Invalid shared memory segment '" + name + "'.");
+    }
+
+    //The counts are loaded before the values they publish are read
+    const SharedHeader* shared = (const SharedHeader*) segment;
+    int64_t finished = __atomic_load_n(&shared->finished, __ATOMIC_ACQUIRE);
+    List            results;
+    List            complete;
+    NumericVector   written;
+    CharacterVector names;
+    for (size_t k = 0; k < directory.size(); k++){
+        std::string variable(directory[k].name);
+        bool chosen = variables.size() == 0;
+        for (int j = 0; j < variables.size(); j++){
+            chosen = chosen || as<std::string>(variables[j]) == variable;
+        }
+        if (!chosen){
+            continue;
+        }
+        const int64_t* columns = (const int64_t*) (segment + directory[k].counts);
+        LogicalVector  done((int) header.ntimes);
+        double         count = 0;
+        for (int j = 0; j < done.size(); j++){
+            int64_t individuals = __atomic_load_n(&columns[j], __ATOMIC_ACQUIRE);
+            done[j] = individuals >= header.nind;
+            count  += (double) individuals;
+        }
+
+        R_xlen_t n = (R_xlen_t) (bytes/sizeof(double));
+#ifdef SHARED_ALTREP
+        List definition = List::create(mapping, NumericVector::create((double) directory[k].offset),
+                                       NumericVector::create((double) n));
+        SEXP values = PROTECT(R_new_altrep(shared_class, definition, R_NilValue));
+#else
+        const double* start = (const double*) (segment + directory[k].offset);
+        SEXP values = PROTECT(Rf_allocVector(REALSXP, n));
+        std::copy(start, start + n, REAL(values));
+#endif
+        IntegerVector dim = IntegerVector::create((int) header.nind, (int) header.ntimes);
+        Rf_setAttrib(values, R_DimSymbol, dim);
+        results.push_back(values, variable);
+        UNPROTECT(1);
+        complete.push_back(done, variable);
+        written.push_back(count);
+        names.push_back(variable);
+    }
+#ifndef SHARED_ALTREP
+    shared_unmap(mapping);
+#endif
+    written.attr("names") = names;
+
+    if (remove){
+        shared_unlink(name);
+    }
+
+    return List::create(Named("Results")  = results,
+                        Named("Written")  = written,
+                        Named("Complete") = complete,
+                        Named("Finished") = finished == 1);
+#endif
+}
@@ -0,0 +1,101 @@
+//
+//  shared.h
+//
+//  This is a function that defines
+//  the shared memory segments of the results of the models in shared.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef shared_h
+#define shared_h
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//Layout of a segment (native byte order). The header is followed by a
+//SharedVariable for each variable, then by the values of each variable as an
+//individual x time matrix of doubles (stored by column so that the values of
+//a time step are contiguous) and then by the progress of each variable: a
+//count for each column of the individuals whose values were written. The
+//blocks of a tiled run fill every column for some individuals at a time, so a
+//column is complete when its count reaches nind. The counts are updated after
+//the values with release semantics so a reader that loads them (with acquire
+//semantics) can read those values. Finished is set to 1 when the model ends.
+//--------------------------------------------------------------------------------
+#define SHARED_MAGIC   "BWSHM01"
+#define SHARED_VERSION 2
+#define SHARED_NAME    48
+
+struct SharedHeader {
+    char    magic[8];
+    int32_t version;
+    int32_t nvars;
+    int64_t nind;
+    int64_t ntimes;
+    int64_t finished;
+};
+
+struct SharedVariable {
+    char    name[SHARED_NAME];
+    int64_t offset;   //Bytes from the start of the segment to the values
+    int64_t counts;   //Bytes from the start of the segment to the ntimes counts
+};
+
+//Create a SinkShared class for the segment shared by all the variables of a
+//model. The variables are added as their trajectories are created and the
+//segment is created when the first value is written.
+//--------------------------------------------------------------------------------
+class SinkShared {
+public:
+
+    SinkShared(std::string input_name);
+    ~SinkShared(void);
+
+    //Functions
+    //---------------------------------------------------------------------------
+    void add(std::string variable, int nind, int ntimes);
+    void write(std::string variable, int first, int column, NumericVector x);
+
+private:
+
+    std::string name;
+    int64_t     nind;
+    int64_t     ntimes;
+    size_t      size;
+    unsigned char* segment;
+
+    std::vector<std::string> variables;
+
+    void create(void);
+};
+
+//Name of a segment as a POSIX shared memory object ("/name")
+std::string shared_name(std::string name);
+
+
+#endif /* shared_h */
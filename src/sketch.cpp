@@ -0,0 +1,193 @@
+//
+//  sketch.cpp
+//
+//  This is a function that builds mergeable weighted quantile sketches of
+//  each group and time step of the results of a model and estimates
+//  their quantiles. Sketches travel as their buckets (sign, index and
+//  weight) so the sketches of chunks of individuals, processes or shards
+//  are merged by putting their buckets together.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <vector>
+#include "sketch.h"
+
+//Values closer to zero than this are in the zero bucket
+const double SKETCH_ZERO = 1.0e-12;
+
+//QuantileSketch
+//--------------------------------------------------------------------------------
+QuantileSketch::QuantileSketch(double input_accuracy){
+    gamma   = (1.0 + input_accuracy)/(1.0 - input_accuracy);
+    lngamma = log(gamma);
+    zero    = 0.0;
+}
+
+QuantileSketch::~QuantileSketch(void){
+
+}
+
+void QuantileSketch::add(double x, double weight){
+    if (ISNAN(x) || weight <= 0){
+        return;
+    }
+    if (fabs(x) < SKETCH_ZERO){
+        zero += weight;
+    } else if (x > 0){
+        positive[(int) ceil(log(x)/lngamma)] += weight;
+    } else {
+        negative[(int) ceil(log(-x)/lngamma)] += weight;
+    }
+}
+
+void QuantileSketch::add(int sign, int index, double weight){
+    if (sign > 0){
+        positive[index] += weight;
+    } else if (sign < 0){
+        negative[index] += weight;
+    } else {
+        zero += weight;
+    }
+}
+
+double QuantileSketch::total(void){
+    double weight = zero;
+    for (std::map<int, double>::iterator it = positive.begin(); it != positive.end(); ++it){
+        weight += it->second;
+    }
+    for (std::map<int, double>::iterator it = negative.begin(); it != negative.end(); ++it){
+        weight += it->second;
+    }
+    return weight;
+}
+
+//Midpoint (in relative terms) of bucket (gamma^(index-1), gamma^index]
+double QuantileSketch::value(int index){
+    return 2.0*exp(index*lngamma)/(gamma + 1.0);
+}
+
+//Value of the bucket where the cumulative weight (from the smallest value)
+//reaches q times the total weight (as quantile type 1 for equal weights)
+double QuantileSketch::quantile(double q){
+    double weight = total();
+    if (weight <= 0){
+        return NA_REAL;
+    }
+    double rank       = q*weight;
+    double cumulative = 0;
+    double last       = NA_REAL;
+    for (std::map<int, double>::reverse_iterator it = negative.rbegin(); it != negative.rend(); ++it){
+        cumulative += it->second;
+        last        = -value(it->first);
+        if (cumulative >= rank){
+            return last;
+        }
+    }
+    if (zero > 0){
+        cumulative += zero;
+        last        = 0.0;
+        if (cumulative >= rank){
+            return last;
+        }
+    }
+    for (std::map<int, double>::iterator it = positive.begin(); it != positive.end(); ++it){
+        cumulative += it->second;
+        last        = value(it->first);
+        if (cumulative >= rank){
+            return last;
+        }
+    }
+    return last;
+}
+
+//Buckets of several sketches
+struct Buckets {
+    std::vector<int>    key;
+    std::vector<int>    sign;
+    std::vector<int>    index;
+    std::vector<double> weight;
+
+    void push(int k, int s, int i, double w){
+        key.push_back(k);
+        sign.push_back(s);
+        index.push_back(i);
+        weight.push_back(w);
+    }
+};
+
+//Sketch of each group (rows) and time step (columns of x) as its buckets: the
+//Key (group + ngroups*column, from 1), Sign, Index and Weight of each bucket
+// [[Rcpp::export]]
+List sketch_wrapper(NumericMatrix x, IntegerVector group, int ngroups, NumericVector weights,
+                    double accuracy){
+
+    Buckets buckets;
+    for (int t = 0; t < x.ncol(); t++){
+        std::vector<QuantileSketch> sketches(ngroups, QuantileSketch(accuracy));
+        for (int i = 0; i < x.nrow(); i++){
+            sketches[group(i) - 1].add(x(i, t), weights(i));
+        }
+        for (int g = 0; g < ngroups; g++){
+            int k = g + ngroups*t + 1;
+            QuantileSketch& sketch = sketches[g];
+            for (std::map<int, double>::iterator it = sketch.negative.begin(); it != sketch.negative.end(); ++it){
+                buckets.push(k, -1, it->first, it->second);
+            }
+            if (sketch.zero > 0){
+                buckets.push(k, 0, 0, sketch.zero);
+            }
+            for (std::map<int, double>::iterator it = sketch.positive.begin(); it != sketch.positive.end(); ++it){
+                buckets.push(k, 1, it->first, it->second);
+            }
+        }
+    }
+
+    return List::create(Named("Key")    = wrap(buckets.key),
+                        Named("Sign")   = wrap(buckets.sign),
+                        Named("Index")  = wrap(buckets.index),
+                        Named("Weight") = wrap(buckets.weight));
+}
+
+//Quantiles (columns) of the sketch of each key (rows) from the buckets of
+//one or more sketches
+// [[Rcpp::export]]
+NumericMatrix sketch_quantile_wrapper(IntegerVector key, IntegerVector sign, IntegerVector index,
+                                      NumericVector weight, int nkeys, NumericVector probs,
+                                      double accuracy){
+
+    std::vector<QuantileSketch> sketches(nkeys, QuantileSketch(accuracy));
+    for (int b = 0; b < key.size(); b++){
+        sketches[key(b) - 1].add(sign(b), index(b), weight(b));
+    }
+
+    NumericMatrix quantiles(nkeys, probs.size());
+    for (int k = 0; k < nkeys; k++){
+        for (int p = 0; p < probs.size(); p++){
+            quantiles(k, p) = sketches[k].quantile(probs(p));
+        }
+    }
+
+    return quantiles;
+}
@@ -0,0 +1,72 @@
+//
+//  sketch.h
+//
+//  This is a function that defines
+//  the quantile sketches of the results of the models in sketch.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef sketch_h
+#define sketch_h
+
+#include <math.h>
+#include <map>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//Create a QuantileSketch class with the weights of the values in buckets of
+//logarithmic width (DDSketch, Masson et al. 2019). Bucket i of the positive
+//values has the values in (gamma^(i-1), gamma^i] with gamma = (1 + a)/(1 - a)
+//so any quantile is estimated with a relative error of at most a (the accuracy).
+//Two sketches merge by adding the weights of their buckets: the result is the
+//sketch of all the values regardless of how they were split.
+//--------------------------------------------------------------------------------
+class QuantileSketch {
+public:
+
+    QuantileSketch(double input_accuracy);
+    ~QuantileSketch(void);
+
+    std::map<int, double> positive;  //Weight of each bucket of the positive values
+    std::map<int, double> negative;  //Weight of each bucket of the absolute negative values
+    double                zero;      //Weight of the values near zero
+
+    //Functions
+    //---------------------------------------------------------------------------
+    void   add(double x, double weight);               //Value
+    void   add(int sign, int index, double weight);    //Bucket (of another sketch)
+    double quantile(double q);
+    double total(void);
+
+private:
+
+    double gamma;
+    double lngamma;
+
+    double value(int index);  //Estimate of the values of a bucket
+};
+
+
+#endif /* sketch_h */
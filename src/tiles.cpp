@@ -0,0 +1,147 @@
+//
+//  tiles.cpp
+//
+//  This is a function that puts together the results of a model that
+//  is run by blocks of individuals (tiles). Each block is advanced through
+//  the whole horizon before moving to the next one so that the state and
+//  parameters of the block stay in cache during all the time steps.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "tiles.h"
+
+//Chosen columns (from 0) of a matrix
+NumericMatrix column_select(NumericMatrix x, IntegerVector columns){
+    NumericMatrix sub(x.nrow(), columns.size());
+    for (int j = 0; j < columns.size(); j++){
+        sub(_,j) = x(_,columns(j));
+    }
+    return sub;
+}
+
+//Copy the rows of a block into the rows start, start + 1, ... of the whole matrix.
+//Both matrices are filled by column so the rows of the block are contiguous.
+template <int RTYPE>
+static void copy_rows(Matrix<RTYPE> whole, Matrix<RTYPE> block, int start){
+    for (int j = 0; j < block.ncol(); j++){
+        for (int i = 0; i < block.nrow(); i++){
+            whole(start + i, j) = block(i, j);
+        }
+    }
+}
+
+//List with the same elements as the results of a block where each
+//individual x time matrix has nind rows
+List allocate_tiles(List block, int nind){
+    PROFILE_SCOPE("tiles");
+    List whole(block.size());
+    for (int k = 0; k < block.size(); k++){
+        SEXP element = block[k];
+        if (Rf_inherits(element, "delta_matrix")){
+            whole[k] = delta_allocate(List(element), nind);
+        } else if (Rf_isMatrix(element) && TYPEOF(element) == REALSXP){
+            whole[k] = NumericMatrix(nind, Rf_ncols(element));
+        } else if (Rf_isMatrix(element) && TYPEOF(element) == STRSXP){
+            whole[k] = StringMatrix(nind, Rf_ncols(element));
+        } else if (Rf_isMatrix(element) && TYPEOF(element) == INTSXP){
+            IntegerMatrix tiles(nind, Rf_ncols(element));
+            tiles.attr("class") = Rf_getAttrib(element, R_ClassSymbol); //e.g. float_matrix
+            whole[k] = tiles;
+        } else if (!Rf_isNull(Rf_getAttrib(element, Rf_install("individuals")))){
+            NumericVector means(Rf_length(element)); //mean of all individuals (AGGREGATE_SINK)
+            means.attr("individuals") = nind;
+            whole[k] = means;
+        } else {
+            whole[k] = element;
+        }
+    }
+    whole.attr("names") = block.attr("names");
+    return whole;
+}
+
+//Copy the results of a block into the results of the whole population. The
+//values are correct only if they are correct for every block.
+void copy_tile(List whole, List block, int start){
+    PROFILE_SCOPE("tiles");
+    CharacterVector names = block.attr("names");
+    for (int k = 0; k < block.size(); k++){
+        SEXP element = block[k];
+        if (Rf_inherits(element, "delta_matrix")){
+            List tile = whole[k];
+            delta_copy(tile, List(element), start);
+        } else if (Rf_isMatrix(element) && TYPEOF(element) == REALSXP){
+            NumericMatrix tile = whole[k];
+            copy_rows<REALSXP>(tile, NumericMatrix(element), start);
+        } else if (Rf_isMatrix(element) && TYPEOF(element) == STRSXP){
+            StringMatrix tile = whole[k];
+            copy_rows<STRSXP>(tile, StringMatrix(element), start);
+        } else if (Rf_isMatrix(element) && TYPEOF(element) == INTSXP){
+            IntegerMatrix tile = whole[k];
+            copy_rows<INTSXP>(tile, IntegerMatrix(element), start);
+        } else if (!Rf_isNull(Rf_getAttrib(element, Rf_install("individuals")))){
+            //Mean of the population weighted by the individuals of the block
+            NumericVector tile  = whole[k];
+            NumericVector means = element;
+            double weight = as<double>(means.attr("individuals"))/as<double>(tile.attr("individuals"));
+            for (int j = 0; j < tile.size(); j++){
+                tile(j) += weight*means(j);
+            }
+        } else if (names(k) == "Correct_Values"){
+            whole[k] = as<bool>(whole[k]) && as<bool>(element);
+        } else if (names(k) == "BMI_Transitions" || names(k) == "BMI_Prevalence"){
+            whole[k] = element; //Counts of the blocks so far (shared by the blocks)
+        }
+    }
+}
+
+//Results of the blocks before the one where the run was cancelled (the
+//individuals before start)
+List interrupted_tiles(List whole, int start, int nind){
+    CharacterVector names = whole.attr("names");
+    List partial(whole.size() + 1);
+    CharacterVector partialnames(whole.size() + 1);
+    int columns = 0;
+    for (int k = 0; k < whole.size(); k++){
+        SEXP element = whole[k];
+        if (!Rf_isNull(Rf_getAttrib(element, Rf_install("individuals")))){
+            //Means of the individuals before start
+            NumericVector means = clone(NumericVector(element));
+            for (int j = 0; j < means.size(); j++){
+                means(j) *= (double) nind/start;
+            }
+            means.attr("individuals") = start;
+            partial[k] = means;
+        } else {
+            partial[k] = element;
+        }
+        if (names(k) == "Time"){
+            columns = Rf_length(element);
+        }
+        partialnames(k) = names(k);
+    }
+    partial[whole.size()]      = interrupted(start, columns);
+    partialnames(whole.size()) = "Interrupted";
+    partial.attr("names")      = partialnames;
+    return partial;
+}
@@ -0,0 +1,52 @@
+//
+//  tiles.h
+//
+//  This is a function that defines
+//  the functions in tiles.cpp used to run a model by blocks of individuals
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef tiles_h
+#define tiles_h
+
+#include <Rcpp.h>
+#include "trajectory.h"
+#include "profile.h"
+using namespace Rcpp;
+
+//Chosen columns (from 0) of a matrix
+NumericMatrix column_select(NumericMatrix x, IntegerVector columns);
+
+//List with the same elements as the results of a block where each
+//individual x time matrix has nind rows
+List allocate_tiles(List block, int nind);
+
+//Copy the results of a block into the results of the whole population
+void copy_tile(List whole, List block, int start);
+
+//Results of the blocks before the one where the run was cancelled (the
+//individuals before start)
+List interrupted_tiles(List whole, int start, int nind);
+
+#endif /* tiles_h */
@@ -0,0 +1,704 @@
+//
+//  trajectory.cpp
+//
+//  This is a function that stores the results of the models. Results
+//  can be stored in double precision (a NumericMatrix) or in single
+//  precision which uses half of the memory. Single precision matrices
+//  are integer matrices of class float_matrix whose entries contain the
+//  bits of a float. Compressed matrices (class delta_matrix) store the
+//  trajectory of each individual in chunks of delta encoded steps which
+//  can be decoded independently (see R/model_precision.R).
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include "trajectory.h"
+
+//Bits of a float as an integer
+int float_bits(double x){
+    float value = (float) x;
+    int   bits;
+    memcpy(&bits, &value, sizeof(float));
+    return bits;
+}
+
+//Float whose bits are stored in an integer
+double bits_float(int x){
+    float value;
+    memcpy(&value, &x, sizeof(float));
+    return (double) value;
+}
+
+//Matrix of single precision values
+IntegerMatrix float_encode(NumericMatrix x){
+    IntegerMatrix encoded(x.nrow(), x.ncol());
+    for (int k = 0; k < x.size(); k++){
+        encoded[k] = float_bits(x[k]);
+    }
+    encoded.attr("class") = "float_matrix";
+    return encoded;
+}
+
+//Rows and columns (starting in 0) of a single precision matrix in double precision
+NumericMatrix float_decode(IntegerMatrix x, IntegerVector rows, IntegerVector cols){
+    NumericMatrix decoded(rows.size(), cols.size());
+    for (int j = 0; j < cols.size(); j++){
+        for (int i = 0; i < rows.size(); i++){
+            decoded(i, j) = bits_float(x(rows(i), cols(j)));
+        }
+    }
+    return decoded;
+}
+
+//Append the bytes of a value to the encoded chunks
+template <typename T>
+static void append_bytes(std::vector<unsigned char>& data, T value){
+    unsigned char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+//Value in position m of an encoded chunk
+template <typename T>
+static double read_bytes(const unsigned char* data, int m){
+    T value;
+    memcpy(&value, data + m*sizeof(T), sizeof(T));
+    return (double) value;
+}
+
+//DeltaMatrix
+//--------------------------------------------------------------------------------
+DeltaMatrix::DeltaMatrix(void){
+    nind    = 0;
+    ntimes  = 0;
+    nchunks = 0;
+    filled  = 0;
+    current = 0;
+    quantum = DELTA_QUANTUM;
+}
+
+DeltaMatrix::DeltaMatrix(int input_nind, int input_ntimes, double input_quantum){
+    nind    = input_nind;
+    ntimes  = input_ntimes;
+    quantum = input_quantum;
+    nchunks = (ntimes + DELTA_CHUNK - 1)/DELTA_CHUNK;
+    filled  = 0;
+    current = 0;
+    buffer.resize((size_t) nind*DELTA_CHUNK);
+    base    = NumericMatrix(nind, nchunks);
+    offset  = NumericMatrix(nind, nchunks);
+    width   = IntegerMatrix(nind, nchunks);
+}
+
+DeltaMatrix::~DeltaMatrix(void){
+
+}
+
+//Integer that encodes a value: multiples of quantum or bits of a float
+double DeltaMatrix::quantize(double x){
+    if (quantum > 0){
+        return round(x/quantum);
+    }
+    return (double) float_bits(x);
+}
+
+//Values of all individuals at time step i. Time steps must be set in order.
+void DeltaMatrix::set(int i, NumericVector x){
+    for (int k = 0; k < nind; k++){
+        buffer[k + (size_t) nind*filled] = x(k);
+    }
+    filled++;
+    if (filled == DELTA_CHUNK || i == ntimes - 1){
+        flush();
+    }
+}
+
+//Encode the current chunk of each individual
+void DeltaMatrix::flush(void){
+
+#ifdef BW_PROFILE
+    double start = (double) data.size();
+#endif
+    std::vector<double> q(filled);
+    for (int k = 0; k < nind; k++){
+
+        //Quantized values and largest difference between consecutive values
+        bool   encodable = true;
+        double largest   = 0.0;
+        for (int m = 0; m < filled; m++){
+            double x = buffer[k + (size_t) nind*m];
+            q[m]     = quantize(x);
+            if (!R_finite(x) || fabs(q[m]) > 4503599627370496.0 ||
+                (quantum <= 0 && !R_finite(bits_float((int) q[m])))){
+                encodable = false;
+            } else if (m > 0){
+                largest = std::max(largest, fabs(q[m] - q[m-1]));
+            }
+        }
+
+        //Bytes per difference
+        int bytes = 8;
+        if (encodable && largest <= 127){
+            bytes = 1;
+        } else if (encodable && largest <= 32767){
+            bytes = 2;
+        } else if (encodable && largest <= 2147483647){
+            bytes = 4;
+        }
+
+        base(k, current)   = q[0];
+        offset(k, current) = (double) data.size();
+        width(k, current)  = bytes;
+        for (int m = 0; m < filled; m++){
+            if (bytes == 8){
+                append_bytes<double>(data, buffer[k + (size_t) nind*m]);
+            } else if (m > 0 && bytes == 1){
+                append_bytes<int8_t>(data, (int8_t) (q[m] - q[m-1]));
+            } else if (m > 0 && bytes == 2){
+                append_bytes<int16_t>(data, (int16_t) (q[m] - q[m-1]));
+            } else if (m > 0){
+                append_bytes<int32_t>(data, (int32_t) (q[m] - q[m-1]));
+            }
+        }
+    }
+    PROFILE_COUNT("bytes_written", (double) data.size() - start);
+
+    filled = 0;
+    current++;
+}
+
+List DeltaMatrix::result(void){
+    if (filled > 0){
+        //Chunk of a run that was interrupted: the time steps it did not reach
+        //are NA. The chunks after it are never flushed and stay empty.
+        int steps = std::min(DELTA_CHUNK, ntimes - current*DELTA_CHUNK);
+        for (; filled < steps; filled++){
+            std::fill(buffer.begin() + (size_t) nind*filled, buffer.begin() + (size_t) nind*(filled + 1),
+                      NA_REAL);
+        }
+        flush();
+    }
+    RawVector encoded(data.begin(), data.end());
+    List deltas = List::create(Named("dim")     = IntegerVector::create(nind, ntimes),
+                               Named("quantum") = quantum,
+                               Named("chunk")   = DELTA_CHUNK,
+                               Named("base")    = base,
+                               Named("offset")  = offset,
+                               Named("width")   = width,
+                               Named("segment") = IntegerMatrix(nind, nchunks),
+                               Named("data")    = List::create(encoded));
+    deltas.attr("class") = "delta_matrix";
+    return deltas;
+}
+
+//Matrix compressed by chunks of delta encoded steps
+List delta_encode(NumericMatrix x, double quantum){
+    DeltaMatrix deltas(x.nrow(), x.ncol(), quantum);
+    for (int i = 0; i < x.ncol(); i++){
+        deltas.set(i, x(_,i));
+    }
+    return deltas.result();
+}
+
+//Rows and columns (starting in 0) of a delta_matrix. Each chunk is decoded
+//once for every row so reading a range of days is fast.
+NumericMatrix delta_decode(List x, IntegerVector rows, IntegerVector cols){
+
+    IntegerVector dim     = x["dim"];
+    double        quantum = x["quantum"];
+    int           chunk   = x["chunk"];
+    NumericMatrix base    = x["base"];
+    NumericMatrix offset  = x["offset"];
+    IntegerMatrix width   = x["width"];
+    IntegerMatrix segment = x["segment"];
+    List          data    = x["data"];
+
+    //Encoded chunks are read in place
+    std::vector<const unsigned char*> segments(data.size());
+    for (int s = 0; s < data.size(); s++){
+        segments[s] = RAW(VECTOR_ELT(data, s));
+    }
+
+    NumericMatrix decoded(rows.size(), cols.size());
+    std::vector<double> values(chunk);
+    for (int i = 0; i < rows.size(); i++){
+        int k = rows(i);
+        int c = -1;
+        for (int j = 0; j < cols.size(); j++){
+            int t = cols(j);
+            if (t/chunk != c){
+                c = t/chunk;
+                int n = std::min(chunk, dim(1) - c*chunk);
+                int bytes = width(k, c);
+                const unsigned char* encoded = bytes == 0 ? NULL :
+                    segments[segment(k, c)] + (size_t) offset(k, c);
+                double q = base(k, c);
+                for (int m = 0; m < n; m++){
+                    if (bytes == 0){
+                        values[m] = NA_REAL; //Empty chunk
+                        continue;
+                    }
+                    if (bytes == 8){
+                        values[m] = read_bytes<double>(encoded, m);
+                        continue;
+                    } else if (m > 0 && bytes == 1){
+                        q += read_bytes<int8_t>(encoded, m - 1);
+                    } else if (m > 0 && bytes == 2){
+                        q += read_bytes<int16_t>(encoded, m - 1);
+                    } else if (m > 0){
+                        q += read_bytes<int32_t>(encoded, m - 1);
+                    }
+                    values[m] = quantum > 0 ? q*quantum : bits_float((int) q);
+                }
+            }
+            decoded(i, j) = values[t - c*chunk];
+        }
+    }
+    return decoded;
+}
+
+//Empty delta_matrix with the same chunks as the one of a block and nind rows
+List delta_allocate(List block, int nind){
+    IntegerVector dim   = block["dim"];
+    NumericMatrix base  = block["base"];
+    int nchunks         = base.ncol();
+    List whole = List::create(Named("dim")     = IntegerVector::create(nind, dim(1)),
+                              Named("quantum") = block["quantum"],
+                              Named("chunk")   = block["chunk"],
+                              Named("base")    = NumericMatrix(nind, nchunks),
+                              Named("offset")  = NumericMatrix(nind, nchunks),
+                              Named("width")   = IntegerMatrix(nind, nchunks),
+                              Named("segment") = IntegerMatrix(nind, nchunks),
+                              Named("data")    = List(0));
+    whole.attr("class") = "delta_matrix";
+    return whole;
+}
+
+//Copy the rows of a block into the rows start, start + 1, ... of a delta_matrix.
+//The encoded chunks of the block are kept as they are in a new segment.
+void delta_copy(List whole, List block, int start){
+
+    List wholedata = whole["data"];
+    List blockdata = block["data"];
+    int  nsegments = wholedata.size();
+    List data(nsegments + blockdata.size());
+    for (int s = 0; s < nsegments; s++){
+        data[s] = wholedata[s];
+    }
+    for (int s = 0; s < blockdata.size(); s++){
+        data[nsegments + s] = blockdata[s];
+    }
+    whole["data"] = data;
+
+    NumericMatrix wholebase    = whole["base"];
+    NumericMatrix wholeoffset  = whole["offset"];
+    IntegerMatrix wholewidth   = whole["width"];
+    IntegerMatrix wholesegment = whole["segment"];
+    NumericMatrix blockbase    = block["base"];
+    NumericMatrix blockoffset  = block["offset"];
+    IntegerMatrix blockwidth   = block["width"];
+    IntegerMatrix blocksegment = block["segment"];
+    for (int c = 0; c < blockbase.ncol(); c++){
+        for (int k = 0; k < blockbase.nrow(); k++){
+            wholebase(start + k, c)    = blockbase(k, c);
+            wholeoffset(start + k, c)  = blockoffset(k, c);
+            wholewidth(start + k, c)   = blockwidth(k, c);
+            wholesegment(start + k, c) = nsegments + blocksegment(k, c);
+        }
+    }
+}
+
+//Any stored matrix in double precision
+NumericMatrix stored_values(SEXP x){
+    if (Rf_inherits(x, "delta_matrix")){
+        List deltas(x);
+        IntegerVector dim = deltas["dim"];
+        return delta_decode(deltas, seq_len(dim(0)) - 1, seq_len(dim(1)) - 1);
+    } else if (Rf_inherits(x, "float_matrix")){
+        IntegerMatrix floats(x);
+        return float_decode(floats, seq_len(floats.nrow()) - 1, seq_len(floats.ncol()) - 1);
+    }
+    return NumericMatrix(x);
+}
+
+//Stored matrix in another storage. Elements that are not stored matrices are
+//returned as they are.
+SEXP stored_as(SEXP x, int storage, double quantum){
+
+    int current;
+    if (Rf_inherits(x, "delta_matrix")){
+        current = DELTA_STORAGE;
+        if (storage == DELTA_STORAGE && as<double>(List(x)["quantum"]) == quantum){
+            return x;
+        }
+    } else if (Rf_inherits(x, "float_matrix")){
+        current = SINGLE_STORAGE;
+    } else if (Rf_isMatrix(x) && TYPEOF(x) == REALSXP){
+        current = DOUBLE_STORAGE;
+    } else {
+        return x;
+    }
+    if (current == storage && storage != DELTA_STORAGE){
+        return x;
+    }
+
+    NumericMatrix values = stored_values(x);
+    if (storage == SINGLE_STORAGE){
+        return float_encode(values);
+    } else if (storage == DELTA_STORAGE){
+        return delta_encode(values, quantum);
+    }
+    return values;
+}
+
+//SinkFile
+//--------------------------------------------------------------------------------
+SinkFile::SinkFile(std::string path, IntegerVector input_columns){
+    const int chunk = 1 << 20;
+    bool gzip = path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+    file = NULL;
+    gz   = NULL;
+    if (gzip){
+        gz = gzopen(path.c_str(), "wb");
+    } else {
+        file = fopen(path.c_str(), "wb");
+    }
+    if (file == NULL && gz == NULL){
+        stop("Cannot open file '" + path + "' for writing.");
+    }
+    buffer.resize(chunk);
+    used = 0;
+
+    //Header of the chosen columns
+    const char* names[4] = {"Individual", "Step", "Variable", "Value"};
+    std::string header;
+    for (int k = 0; k < 4; k++){
+        columns[k] = input_columns.size() == 0;
+    }
+    for (int k = 0; k < input_columns.size(); k++){
+        columns[input_columns(k)] = true;
+    }
+    for (int k = 0; k < 4; k++){
+        if (columns[k]){
+            header += (header.empty() ? "" : ",") + std::string(names[k]);
+        }
+    }
+    header += "\n";
+    append(header.c_str(), header.size());
+}
+
+SinkFile::~SinkFile(void){
+    //Only when the run stopped before close(); errors are not reported as
+    //destructors cannot throw
+    if (gz != NULL || file != NULL){
+        flush();
+        if (gz != NULL){
+            gzclose(gz);
+        } else {
+            fclose(file);
+        }
+    }
+}
+
+void SinkFile::close(void){
+    if (gz == NULL && file == NULL){
+        return;
+    }
+    bool written = flush();
+    bool closed  = gz != NULL ? gzclose(gz) == Z_OK : fclose(file) == 0;
+    gz   = NULL;
+    file = NULL;
+    if (!written || !closed){
+        stop("Cannot write the results to the file.");
+    }
+}
+
+void SinkFile::write(int individual, int step, const std::string& variable, double value){
+    char text[32];
+    int  n = snprintf(text, sizeof(text), "%.10g", value);
+    row(individual, step, variable, text, n);
+}
+
+void SinkFile::write(int individual, int step, const std::string& variable, const char* value){
+    row(individual, step, variable, value, strlen(value));
+}
+
+//Row with the chosen columns
+void SinkFile::row(int individual, int step, const std::string& variable, const char* value,
+                   size_t n){
+    char   text[64];
+    size_t length = 0;
+    if (columns[INDIVIDUAL_COLUMN]){
+        length += snprintf(text + length, sizeof(text) - length, "%d,", individual);
+    }
+    if (columns[STEP_COLUMN]){
+        length += snprintf(text + length, sizeof(text) - length, "%d,", step);
+    }
+    append(text, length);
+    if (columns[VARIABLE_COLUMN]){
+        append(variable.c_str(), variable.size());
+        append(",", 1);
+    }
+    if (columns[VALUE_COLUMN]){
+        append(value, n);
+        append(",", 1);
+    }
+    buffer[used - 1] = '\n'; //Last separator ends the row
+    PROFILE_COUNT("bytes_written", (double) length + columns[VARIABLE_COLUMN]*(variable.size() + 1) +
+                                   columns[VALUE_COLUMN]*(n + 1));
+}
+
+void SinkFile::append(const char* text, size_t n){
+    if (used + n > buffer.size() && !flush()){
+        stop("Cannot write the results to the file.");
+    }
+    memcpy(buffer.data() + used, text, n);
+    used += n;
+}
+
+//Write the buffered rows; false if they could not be written
+bool SinkFile::flush(void){
+    if (used == 0){
+        return true;
+    }
+    bool written = gz != NULL ? gzwrite(gz, buffer.data(), used) == (int) used :
+                                fwrite(buffer.data(), 1, used, file) == used;
+    used = 0;
+    return written;
+}
+
+//Output
+//--------------------------------------------------------------------------------
+Output::Output(void){
+    storage   = DOUBLE_STORAGE;
+    quantum   = DELTA_QUANTUM;
+    sink      = FULL_SINK;
+    every      = 1;
+    first      = 0;
+    population = 0;
+    variables  = CharacterVector(0);
+}
+
+Output::Output(List options){
+    storage   = as<int>(options["storage"]);
+    quantum   = as<double>(options["quantum"]);
+    variables = options["variables"];
+    sink      = as<int>(options["sink"]);
+    every      = sink == DECIMATED_SINK ? as<int>(options["every"]) : 1;
+    first      = 0;
+    population = 0;
+    if (sink == FILE_SINK){
+        IntegerVector columns = options.containsElementNamed("columns") ?
+            as<IntegerVector>(options["columns"]) : IntegerVector(0);
+        file = std::make_shared<SinkFile>(as<std::string>(options["file"]), columns);
+    }
+    if (sink == SHARED_SINK){
+        shared = std::make_shared<SinkShared>(as<std::string>(options["file"]));
+    }
+    if (options.containsElementNamed("interval")){
+        SEXP callback = options["progress"]; //Function or NULL
+        progress = std::make_shared<Progress>(Nullable<Function>(callback), as<double>(options["interval"]));
+    }
+    if (options.containsElementNamed("transitions") && !Rf_isNull(options["transitions"])){
+        List chosen = options["transitions"];
+        transitions = std::make_shared<Transitions>(chosen["steps"], chosen["group"],
+                                                    as<int>(chosen["ngroups"]), chosen["weights"]);
+    }
+    if (options.containsElementNamed("categories") && !Rf_isNull(options["categories"])){
+        List chosen = options["categories"];
+        categories = std::make_shared<Categories>(chosen["table"], as<bool>(chosen["prevalence"]),
+                                                  chosen["group"], as<int>(chosen["ngroups"]),
+                                                  chosen["weights"]);
+    }
+}
+
+Output::~Output(void){
+
+}
+
+//Whether the variable is recorded (all are if no variable was chosen)
+bool Output::records(std::string name){
+    if (variables.size() == 0){
+        return true;
+    }
+    for (int k = 0; k < variables.size(); k++){
+        if (as<std::string>(variables[k]) == name){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Output::matrices(void){
+    return sink == FULL_SINK || sink == DECIMATED_SINK;
+}
+
+//Column of time step i (-1 if the step is not recorded)
+int Output::column(int i){
+    if (i % every != 0){
+        return -1;
+    }
+    return i/every;
+}
+
+int Output::columns(int ntimes){
+    return (ntimes - 1)/every + 1;
+}
+
+NumericVector Output::times(NumericVector time){
+    NumericVector recorded(columns(time.size()));
+    for (int i = 0; i < recorded.size(); i++){
+        recorded(i) = time(i*every);
+    }
+    return recorded;
+}
+
+//Report time step i of nsteps of the nind individuals of a block. Returns false
+//if the run was cancelled.
+bool Output::proceed(int i, int nsteps, int nind){
+    if (!progress){
+        return true;
+    }
+    double everyone = population > 0 ? population : nind;
+    return progress->update((double) first*nsteps + (double) nind*i, everyone*nsteps);
+}
+
+//The rows of the file sink are written when the run ends (all of its blocks)
+void Output::close(void){
+    if (file){
+        file->close();
+    }
+}
+
+//Results without the variables that were not recorded (NULL elements)
+List recorded(List results){
+    CharacterVector names = results.attr("names");
+    int n = 0;
+    for (int k = 0; k < results.size(); k++){
+        n += !Rf_isNull(results[k]);
+    }
+    List kept(n);
+    CharacterVector keptnames(n);
+    for (int k = 0, j = 0; k < results.size(); k++){
+        if (!Rf_isNull(results[k])){
+            kept[j]      = results[k];
+            keptnames[j] = names[k];
+            j++;
+        }
+    }
+    kept.attr("names") = keptnames;
+    return kept;
+}
+
+//Individuals and recorded time steps of a run that was cancelled
+IntegerVector interrupted(int individuals, int columns){
+    return IntegerVector::create(Named("Individuals") = individuals, Named("Columns") = columns);
+}
+
+//Trajectory
+//--------------------------------------------------------------------------------
+Trajectory::Trajectory(int input_nind, int input_ntimes, Output input_output, std::string input_name,
+                       bool input_derived){
+    output    = input_output;
+    name      = input_name;
+    nind      = input_nind;
+    ntimes    = output.columns(input_ntimes);
+    storage   = output.storage;
+    derived   = input_derived;
+    recording = output.records(name);
+    if (!recording || lazy() || output.sink == FILE_SINK){
+        return;
+    } else if (output.sink == SHARED_SINK){
+        output.shared->add(name, output.population > 0 ? output.population : nind, ntimes);
+        return;
+    } else if (output.sink == AGGREGATE_SINK){
+        means = NumericVector(ntimes);
+        means.attr("individuals") = nind;
+        PROFILE_COUNT("bytes_allocated", 8.0*ntimes);
+    } else if (storage == SINGLE_STORAGE){
+        floats = IntegerMatrix(nind, ntimes);
+        floats.attr("class") = "float_matrix";
+        PROFILE_COUNT("bytes_allocated", 4.0*nind*ntimes);
+    } else if (storage == DELTA_STORAGE){
+        deltas = DeltaMatrix(nind, ntimes, output.quantum);
+    } else {
+        values = NumericMatrix(nind, ntimes);
+        PROFILE_COUNT("bytes_allocated", 8.0*nind*ntimes);
+    }
+    PROFILE_COUNT("allocations", 1);
+}
+
+Trajectory::~Trajectory(void){
+
+}
+
+//Values of all individuals at time step i
+void Trajectory::set(int i, NumericVector x){
+    int j = output.column(i);
+    if (!recording || lazy() || j < 0){
+        return;
+    } else if (output.sink == FILE_SINK){
+        for (int k = 0; k < nind; k++){
+            output.file->write(output.first + k + 1, i, name, x(k));
+        }
+    } else if (output.sink == SHARED_SINK){
+        output.shared->write(name, output.first, j, x);
+    } else if (output.sink == AGGREGATE_SINK){
+        means(j) = mean(x);
+        PROFILE_COUNT("bytes_written", 8.0);
+    } else if (storage == SINGLE_STORAGE){
+        for (int k = 0; k < nind; k++){
+            floats(k, j) = float_bits(x(k));
+        }
+        PROFILE_COUNT("bytes_written", 4.0*nind);
+    } else if (storage == DELTA_STORAGE){
+        deltas.set(j, x);
+    } else {
+        values(_, j) = x;
+        PROFILE_COUNT("bytes_written", 8.0*nind);
+    }
+}
+
+SEXP Trajectory::result(void){
+    if (!recording || output.sink == FILE_SINK || output.sink == SHARED_SINK){
+        return R_NilValue;
+    } else if (output.sink == AGGREGATE_SINK){
+        return means;
+    } else if (storage == SINGLE_STORAGE){
+        return floats;
+    } else if (storage == DELTA_STORAGE){
+        return deltas.result();
+    }
+    return values;
+}
+
+//Derived results in double precision are not stored; the model returns them
+//as lazy matrices (see lazy.h)
+bool Trajectory::lazy(void){
+    return recording && derived && storage == DOUBLE_STORAGE && output.matrices();
+}
+
+bool Trajectory::records(void){
+    return recording;
+}
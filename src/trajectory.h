@@ -0,0 +1,247 @@
+//
+//  trajectory.h
+//
+//  This is a function that defines
+//  all the variables needed in trajectory.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef trajectory_h
+#define trajectory_h
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <zlib.h>
+#include <Rcpp.h>
+#include "profile.h"
+#include "progress.h"
+#include "shared.h"
+#include "transitions.h"
+#include "categories.h"
+using namespace Rcpp;
+
+//Precision in which the results of the models are stored
+enum Storage {
+    DOUBLE_STORAGE = 0,  //NumericMatrix
+    SINGLE_STORAGE = 1,  //float_matrix: integer matrix with the bits of a float in each entry
+    DELTA_STORAGE  = 2   //delta_matrix: chunks of delta encoded steps of each individual
+};
+
+//Default quantum (1 g for masses) and time steps per chunk of a delta_matrix
+const double DELTA_QUANTUM = 0.001;
+const int    DELTA_CHUNK   = 128;
+
+//Single precision values stored in the bits of an integer
+int    float_bits(double x);
+double bits_float(int x);
+
+//Matrix of single precision values (class float_matrix)
+IntegerMatrix float_encode(NumericMatrix x);
+NumericMatrix float_decode(IntegerMatrix x, IntegerVector rows, IntegerVector cols);
+
+//Compressed matrix (class delta_matrix)
+List          delta_encode(NumericMatrix x, double quantum);
+NumericMatrix delta_decode(List x, IntegerVector rows, IntegerVector cols);
+List          delta_allocate(List block, int nind);
+void          delta_copy(List whole, List block, int start);
+
+//Any stored matrix in double precision and in another storage
+NumericMatrix stored_values(SEXP x);
+SEXP          stored_as(SEXP x, int storage, double quantum);
+
+//Create a DeltaMatrix class that compresses an individual x time matrix while it
+//is filled one time step at a time. The steps of each individual are split in
+//chunks of DELTA_CHUNK time steps; each chunk stores its first value and the
+//differences between consecutive values in 1, 2 or 4 bytes (whatever the
+//largest difference needs). Values are quantized to multiples of quantum or,
+//if quantum is 0, kept exactly as single precision values (the differences are
+//taken between the bits of the floats). Chunks with values that cannot be
+//encoded (NA, NaN, infinity or huge differences) are stored as doubles. Chunks
+//that a run did not reach (it was interrupted) have width 0 and are all NA.
+//--------------------------------------------------------------------------------
+class DeltaMatrix {
+public:
+
+    DeltaMatrix(void);
+    DeltaMatrix(int input_nind, int input_ntimes, double input_quantum);
+    ~DeltaMatrix(void);
+
+    //Functions
+    //---------------------------------------------------------------------------
+    void set(int i, NumericVector x);   //Values of all individuals at time step i (in order)
+    List result(void);
+
+private:
+
+    int    nind;
+    int    ntimes;
+    int    nchunks;
+    int    filled;     //Time steps of the current chunk
+    int    current;    //Current chunk
+    double quantum;
+
+    std::vector<double>        buffer;  //Values of the current chunk (nind x DELTA_CHUNK)
+    std::vector<unsigned char> data;    //Encoded chunks
+
+    //Index of each individual x chunk
+    NumericMatrix base;
+    NumericMatrix offset;
+    IntegerMatrix width;
+
+    double quantize(double x);
+    void   flush(void);
+};
+
+//Where the results of the models go
+enum Sink {
+    FULL_SINK      = 0,  //individual x time matrices
+    DECIMATED_SINK = 1,  //individual x time matrices with every k-th time step
+    AGGREGATE_SINK = 2,  //mean of all individuals at each time step
+    FILE_SINK      = 3,  //rows of a csv file
+    SHARED_SINK    = 4   //individual x time matrices in a shared memory segment
+};
+
+//Columns of the rows of a SinkFile
+enum Column {
+    INDIVIDUAL_COLUMN = 0,
+    STEP_COLUMN       = 1,
+    VARIABLE_COLUMN   = 2,
+    VALUE_COLUMN      = 3
+};
+
+//Create a SinkFile class for the csv file shared by all the variables of a model
+//with a row for each individual, time step and variable (long format). Rows are
+//formatted into a buffer that is written in large chunks; files ending in ".gz"
+//are gzip compressed. Only the chosen columns (all if none) are written.
+//--------------------------------------------------------------------------------
+class SinkFile {
+public:
+
+    SinkFile(std::string path, IntegerVector input_columns = IntegerVector(0));
+    ~SinkFile(void);
+
+    //Functions
+    //---------------------------------------------------------------------------
+    void write(int individual, int step, const std::string& variable, double value);
+    void write(int individual, int step, const std::string& variable, const char* value);
+    void close(void);  //Write the buffered rows and close the file (error if they cannot be written)
+
+private:
+
+    FILE*             file;
+    gzFile            gz;
+    bool              columns[4];
+    std::vector<char> buffer;
+    size_t            used;
+
+    void row(int individual, int step, const std::string& variable, const char* value, size_t n);
+    void append(const char* text, size_t n);
+    bool flush(void);
+};
+
+//Create an Output class with the results that the models record: the variables
+//(all of them if none is given), their storage and where they go. The solvers
+//keep their state in rolling vectors and hand each time step to the output.
+//--------------------------------------------------------------------------------
+class Output {
+public:
+
+    Output(void);
+    Output(List options);
+    ~Output(void);
+
+    int    storage;
+    double quantum;
+    int    sink;
+    int    every;       //Time steps between recorded steps (DECIMATED_SINK)
+    int    first;       //Position of the first individual (for blocks)
+    int    population;  //Individuals of the whole run (for blocks)
+
+    std::shared_ptr<SinkFile>   file;
+    std::shared_ptr<SinkShared> shared;
+    std::shared_ptr<Progress> progress;
+    std::shared_ptr<Transitions> transitions;  //BMI category transitions (adults)
+    std::shared_ptr<Categories>  categories;   //BMI-for-age categories (children)
+
+    //Functions
+    //---------------------------------------------------------------------------
+    bool          records(std::string name);   //Whether the variable is recorded
+    bool          matrices(void);               //Whether results are individual x time matrices
+    int           column(int i);                //Column of time step i (-1 if not recorded)
+    int           columns(int ntimes);          //Number of recorded time steps
+    NumericVector times(NumericVector time);    //Recorded times
+    bool          proceed(int i, int nsteps, int nind);  //Report step i; false if cancelled
+    void          close(void);                  //End the sinks of the run
+
+private:
+
+    CharacterVector variables;
+};
+
+//Results without the variables that were not recorded
+List recorded(List results);
+
+//Individuals and recorded time steps of a run that was cancelled
+IntegerVector interrupted(int individuals, int columns);
+
+//Create a Trajectory class that stores an individual x time result of a model
+//in the chosen precision. The models integrate in double precision and only
+//the stored values are rounded. Results derived from other results (e.g. age)
+//are not stored in double precision as the model computes them lazily and
+//variables that are not recorded are not stored at all.
+//--------------------------------------------------------------------------------
+class Trajectory {
+public:
+
+    Trajectory(int input_nind, int input_ntimes, Output output, std::string name,
+               bool input_derived = false);
+    ~Trajectory(void);
+
+    //Functions
+    //---------------------------------------------------------------------------
+    void set(int i, NumericVector x);   //Values of all individuals at time step i
+    SEXP result(void);                  //NULL if the variable is not recorded, in a file or shared
+    bool lazy(void);                    //Result is not stored
+    bool records(void);
+
+private:
+
+    int nind;
+    int ntimes;
+    int storage;
+    bool derived;
+    bool recording;
+    std::string name;
+    Output output;
+    NumericVector means;
+    NumericMatrix values;
+    IntegerMatrix floats;
+    DeltaMatrix   deltas;
+};
+
+#endif /* trajectory_h */
@@ -0,0 +1,65 @@
+//
+//  trajectory_wrapper.cpp
+//
+//  This is a function that changes the precision in which the results
+//  of the models are stored and reads single precision (class float_matrix)
+//  and compressed (class delta_matrix) matrices in double precision.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+
+#include <Rcpp.h>
+#include "trajectory.h"
+
+// [[Rcpp::export]]
+List precision_wrapper(List model, int storage, double quantum){
+
+    //Only the matrices in another storage are converted; other elements are shared
+    List result(model.size());
+    for (int k = 0; k < model.size(); k++){
+        result[k] = stored_as(model[k], storage, quantum);
+    }
+    result.attr("names") = model.attr("names");
+    if (model.hasAttribute("layout")){
+        result.attr("layout") = model.attr("layout");
+    }
+    if (model.hasAttribute("Profile")){
+        result.attr("Profile") = model.attr("Profile");
+    }
+
+    return result;
+}
+
+//Rows and columns (starting in 0) of a float_matrix in double precision
+// [[Rcpp::export]]
+NumericMatrix float_decode_wrapper(IntegerMatrix x, IntegerVector rows, IntegerVector cols){
+    return float_decode(x, rows, cols);
+}
+
+//Rows and columns (starting in 0) of a delta_matrix
+// [[Rcpp::export]]
+NumericMatrix delta_decode_wrapper(List x, IntegerVector rows, IntegerVector cols){
+    return delta_decode(x, rows, cols);
+}
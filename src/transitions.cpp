@@ -0,0 +1,97 @@
+//
+//  transitions.cpp
+//
+//  This is a function that counts
+//  the BMI category transitions of the adult model
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "transitions.h"
+
+int bmi_category(double BMI){
+    if (ISNAN(BMI)){
+        return -1;
+    } else if (BMI < 18.5){
+        return 0;
+    } else if (BMI < 25){
+        return 1;
+    } else if (BMI < 30){
+        return 2;
+    }
+    return 3;
+}
+
+//Steps are the sorted time steps where the individuals are classified; the
+//transitions of interval k go from steps(k) to steps(k + 1)
+Transitions::Transitions(IntegerVector input_steps, IntegerVector input_group, int input_ngroups,
+                         NumericVector input_weights){
+    std::vector<int> steps = as< std::vector<int> >(input_steps);
+    ngroups    = input_ngroups;
+    nintervals = std::max((int) steps.size() - 1, 0);
+    interval   = std::vector<int>(steps.empty() ? 0 : *std::max_element(steps.begin(), steps.end()) + 1, -1);
+    for (size_t k = 0; k < steps.size(); k++){
+        interval[steps[k]] = k;
+    }
+    group    = as< std::vector<int> >(input_group);
+    weights  = as< std::vector<double> >(input_weights);
+    previous = std::vector<int>(group.size(), -1);
+    counts   = std::vector<double>((size_t) BMI_CATEGORIES*BMI_CATEGORIES*ngroups*nintervals, 0.0);
+}
+
+Transitions::~Transitions(void){
+
+}
+
+//Classify the BMI of the individuals first, first + 1, ... at time step i and
+//count their transitions from the previous chosen step. Individuals with an
+//unknown category at either step are not counted.
+void Transitions::classify(int i, int first, NumericVector BMI){
+    if (i >= (int) interval.size() || interval[i] < 0){
+        return;
+    }
+    int    k    = interval[i];
+    size_t size = (size_t) BMI_CATEGORIES*BMI_CATEGORIES;
+    for (int j = 0; j < BMI.size(); j++){
+        int individual = first + j;
+        int category   = bmi_category(BMI(j));
+        if (k > 0 && previous[individual] >= 0 && category >= 0){
+            size_t cell = previous[individual] + BMI_CATEGORIES*category +
+                size*(group[individual] + (size_t) ngroups*(k - 1));
+            counts[cell] += weights[individual];
+        }
+        previous[individual] = category;
+    }
+}
+
+//Counts of each interval as a from x to x group array
+List Transitions::result(void){
+    List intervals(nintervals);
+    size_t size = (size_t) BMI_CATEGORIES*BMI_CATEGORIES*ngroups;
+    for (int k = 0; k < nintervals; k++){
+        NumericVector array(counts.begin() + size*k, counts.begin() + size*(k + 1));
+        array.attr("dim") = IntegerVector::create(BMI_CATEGORIES, BMI_CATEGORIES, ngroups);
+        intervals[k] = array;
+    }
+    return intervals;
+}
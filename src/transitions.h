@@ -0,0 +1,76 @@
+//
+//  transitions.h
+//
+//  This is a function that defines
+//  the BMI category transitions of the adult model in transitions.cpp
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+
+#ifndef transitions_h
+#define transitions_h
+
+#include <vector>
+#include <algorithm>
+#include <Rcpp.h>
+using namespace Rcpp;
+
+//BMI categories of adults (as in Adult::BMIClassifier)
+const int BMI_CATEGORIES = 4;  //Underweight, Normal, Pre-Obese and Obese
+
+//Category of a BMI (from 0) or -1 if it is unknown (NA or NaN)
+int bmi_category(double BMI);
+
+//Create a Transitions class that counts the (weighted) individuals of each
+//group that move from one BMI category to another between consecutive chosen
+//time steps. The model classifies the individuals at the chosen time steps
+//only and keeps their previous category instead of the category history.
+//Blocks of individuals share the counts.
+//--------------------------------------------------------------------------------
+class Transitions {
+public:
+
+    Transitions(IntegerVector input_steps, IntegerVector input_group, int input_ngroups,
+                NumericVector input_weights);
+    ~Transitions(void);
+
+    //Functions
+    //---------------------------------------------------------------------------
+    void classify(int i, int first, NumericVector BMI);  //Time step i of individuals first, first + 1, ...
+    List result(void);  //Category x category x group array of each interval
+
+private:
+
+    int ngroups;
+    int nintervals;
+
+    std::vector<int>    interval;  //Interval that ends at each time step (-1 if not chosen, 0 for the first)
+    std::vector<int>    group;     //Group of each individual (from 0)
+    std::vector<double> weights;
+    std::vector<int>    previous;  //Category of each individual at the last chosen time step
+    std::vector<double> counts;    //From x to x group x interval
+};
+
+
+#endif /* transitions_h */
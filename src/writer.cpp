@@ -0,0 +1,82 @@
+//
+//  writer.cpp
+//
+//  This is a function that writes the results of a model to a long
+//  format csv file (optionally gzip compressed) with a row for each
+//  individual, time step and variable. The rows are streamed from the
+//  matrices through a SinkFile so no data frame is built.
+//
+//  Authors:
+//  Dalia Camacho-García-Formentí
+//  Rodrigo Zepeda-Tello
+//
+//----------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------
+// License: MIT
+// Copyright 2018 Instituto Nacional de Salud Pública de México
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies
+// or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------------------
+
+#include "trajectory.h"
+
+//Write the matrices of the model (with a row for each individual and in double
+//precision, integers or strings). Rows go time step by time step as in sink = "file".
+// [[Rcpp::export]]
+double write_wrapper(List model, std::string path, IntegerVector columns){
+
+    CharacterVector names = model.attr("names");
+    int nvars  = model.size();
+    int ntimes = 0;
+    for (int k = 0; k < nvars; k++){
+        ntimes = std::max(ntimes, Rf_ncols(model[k]));
+    }
+
+    SinkFile file(path, columns);
+    double rows = 0;
+    for (int j = 0; j < ntimes; j++){
+        for (int k = 0; k < nvars; k++){
+            SEXP        element = model[k];
+            std::string name    = as<std::string>(names[k]);
+            int         nind    = Rf_nrows(element);
+            if (j >= Rf_ncols(element)){
+                continue;
+            }
+            if (TYPEOF(element) == STRSXP){
+                for (int i = 0; i < nind; i++){
+                    file.write(i + 1, j, name, CHAR(STRING_ELT(element, i + (R_xlen_t) nind*j)));
+                }
+            } else if (TYPEOF(element) == INTSXP){
+                const int* values = INTEGER(element) + (R_xlen_t) nind*j;
+                for (int i = 0; i < nind; i++){
+                    if (values[i] == NA_INTEGER){
+                        file.write(i + 1, j, name, "NA");
+                    } else {
+                        file.write(i + 1, j, name, (double) values[i]);
+                    }
+                }
+            } else {
+                const double* values = REAL(element) + (R_xlen_t) nind*j;
+                for (int i = 0; i < nind; i++){
+                    file.write(i + 1, j, name, values[i]);
+                }
+            }
+            rows += nind;
+        }
+    }
+    file.close();
+
+    return rows;
+}